@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+#include "game.h"
+#include "grid.h"
+#include "movegen.h"
+#include "piecequeue.h"
+#include "stackfeatures.h"
+#include "vectorenv.h"
+
+
+// Heap allocations made by the benchmark binary, counted by the replaced `operator new`
+static uint64_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *pointer = malloc(size ? size : 1);
+
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    free(pointer);
+}
+
+// Repetitions of every benchmark; the first `warmupReps` are discarded
+const int warmupReps = 3;
+const int measuredReps = 15;
+
+// Keeps the compiler from optimising away a result
+template <typename T>
+inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Times an operation and prints its statistics.
+ * @details Each repetition calls `setup()` untimed, then `run(i)` for `i` from `0` to `batch - 1` timed.
+ * Reports the median and minimum time per operation, the spread between repetitions (relative standard
+ * deviation) and the heap allocations per operation.
+ * @param name Name printed in the report.
+ * @param batch Operations per repetition.
+ * @param setup Prepares the state the operations work on, e.g. fresh copies of a grid.
+ * @param run Performs operation `i`.
+ */
+template <typename Setup, typename Run>
+void Benchmark(const char *name, int batch, Setup setup, Run run) {
+    std::vector<double> samples;
+    uint64_t allocationsMeasured = 0;
+    samples.reserve(warmupReps + measuredReps);
+
+    for (int rep = 0; rep < warmupReps + measuredReps; rep++) {
+        setup();
+
+        uint64_t allocationsBefore = allocations;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < batch; i++) {
+            run(i);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        if (rep >= warmupReps) {
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / batch);
+            allocationsMeasured += allocations - allocationsBefore;
+        }
+    }
+
+    double mean = 0;
+    for (double sample: samples) {
+        mean += sample;
+    }
+    mean /= samples.size();
+
+    double variance = 0;
+    for (double sample: samples) {
+        variance += (sample - mean) * (sample - mean);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double spread = (mean > 0) ? 100 * sqrt(variance / samples.size()) / mean : 0;
+
+    printf("%-36s %12.2f %12.2f %8.1f%% %10.2f\n", name, samples[samples.size() / 2], samples[0], spread,
+           (double)allocationsMeasured / ((double)measuredReps * batch));
+}
+
+/// @brief Fills rows of a grid from the floor up, leaving one gap per row unless the row is full.
+/// @param fullRows Number of full rows at the bottom.
+/// @param partialRows Number of rows with a single gap above them.
+Grid MakeGrid(int fullRows, int partialRows) {
+    Grid grid;
+
+    for (int i = 0; i < fullRows + partialRows; i++) {
+        int row = 19 - i;
+
+        for (int col = 0; col < 10; col++) {
+            if (i < fullRows || col != (i * 3) % 10) {
+                grid.SetCell(row, col, 1 + (row + col) % 7);
+            }
+        }
+    }
+
+    return grid;
+}
+
+/// @brief Fills every other row in the bottom half, so that full rows are interleaved with partial ones.
+Grid MakeInterleavedGrid() {
+    Grid grid = MakeGrid(0, 10);
+
+    for (int row = 19; row >= 10; row -= 2) {
+        for (int col = 0; col < 10; col++) {
+            grid.SetCell(row, col, 2);
+        }
+    }
+
+    return grid;
+}
+
+/// @brief Fills a jagged stack with overhangs, used for collision, drop and rotation benchmarks.
+Grid MakeStackGrid() {
+    Grid grid;
+    const int heights[10] = {6, 9, 4, 7, 2, 8, 5, 10, 3, 6};
+
+    for (int col = 0; col < 10; col++) {
+        for (int row = 19; row > 19 - heights[col]; row--) {
+            if ((row + col) % 4 != 0) {
+                grid.SetCell(row, col, 1 + col % 7);
+            }
+        }
+    }
+
+    return grid;
+}
+
+int main() {
+    const int batch = 4096;
+    std::vector<Grid> grids(batch);
+
+    printf("%-36s %12s %12s %9s %10s\n", "benchmark", "median ns", "min ns", "spread", "allocs/op");
+
+    // Line clears on different fill patterns
+    struct {
+        const char *name;
+        Grid grid;
+    } patterns[] = {
+        {"Grid::ClearFullRows (empty)", Grid()},
+        {"Grid::ClearFullRows (no full rows)", MakeGrid(0, 12)},
+        {"Grid::ClearFullRows (tetris)", MakeGrid(4, 8)},
+        {"Grid::ClearFullRows (interleaved)", MakeInterleavedGrid()},
+        {"Grid::ClearFullRows (all full)", MakeGrid(20, 0)},
+    };
+
+    for (auto &pattern: patterns) {
+        Benchmark(pattern.name, batch,
+            [&]() { std::fill(grids.begin(), grids.end(), pattern.grid); },
+            [&](int i) { DoNotOptimize(grids[i].ClearFullRows()); });
+    }
+
+    // Collision and boundary tests at every position of every tetromino
+    Grid stack = MakeStackGrid();
+    std::vector<Block> positions;
+    for (int id = 1; id <= numTetrominoes; id++) {
+        for (int rotation = 0; rotation < tetrominoRotations[id]; rotation++) {
+            for (int row = -2; row < 20; row++) {
+                for (int col = -3; col < 10; col++) {
+                    Block block = Block(id);
+                    block.rotationState = (int8_t)rotation;
+                    block.row = (int8_t)row;
+                    block.col = (int8_t)col;
+                    positions.push_back(block);
+                }
+            }
+        }
+    }
+
+    int numPositions = (int)positions.size();
+    Benchmark("Grid::Collides", numPositions, []() {}, [&](int i) {
+        const Block &block = positions[i];
+        DoNotOptimize(stack.Collides(block.row, block.col, block.GetShape()));
+    });
+
+    Benchmark("Grid::IsOutsideBoundary", numPositions, []() {}, [&](int i) {
+        DoNotOptimize(stack.IsOutsideBoundary(positions[i].row, positions[i].col));
+    });
+
+    // Drop distance of every non-colliding position, as used by the ghost block and hard drop
+    std::vector<Block> free;
+    for (const Block &block: positions) {
+        if (!stack.Collides(block.row, block.col, block.GetShape())) {
+            free.push_back(block);
+        }
+    }
+
+    int numFree = (int)free.size();
+    Benchmark("Grid::DropDistance (ghost)", numFree, []() {}, [&](int i) {
+        const Block &block = free[i];
+        DoNotOptimize(stack.DropDistance(block.row, block.col, block.GetShape(), block.GetBottoms()));
+    });
+
+    // Rotation including the wall kick tests, and their failure, on the jagged stack
+    std::vector<Block> rotated(numFree);
+    Benchmark("Block::Rotate (with wall kicks)", numFree,
+        [&]() { std::copy(free.begin(), free.end(), rotated.begin()); },
+        [&](int i) { DoNotOptimize(rotated[i].Rotate(stack, (i & 1) == 0)); });
+
+    // Dealing tetrominoes from the 7-bag
+    PieceQueue queue;
+    Benchmark("PieceQueue::Pop (7-bag)", batch * 16, []() {}, [&](int i) { DoNotOptimize(queue.Pop()); });
+
+    // Locking and scoring through the public API: each placement runs LockBlock(), ClearFullRows() and UpdateScore()
+    const int numGames = 64;
+    std::vector<Game> games;
+    std::vector<Placement> placements;
+    MoveGenerator moves;
+
+    for (int i = 0; i < numGames; i++) {
+        Game game = Game((uint32_t)i);
+        game.Execute(Command::Restart);
+        games.push_back(game);
+
+        moves.Generate(game.GetGrid(), game.GetCurrentBlock());
+        placements.push_back(moves.placements[i % moves.numPlacements]);
+    }
+
+    std::vector<Game> working = games;
+    Benchmark("Game::Place (LockBlock + UpdateScore)", numGames,
+        [&]() { std::copy(games.begin(), games.end(), working.begin()); },
+        [&](int i) { DoNotOptimize(working[i].Place(placements[i])); });
+
+    Benchmark("Game::Execute(HardDrop)", numGames,
+        [&]() { std::copy(games.begin(), games.end(), working.begin()); },
+        [&](int i) { working[i].Execute(Command::HardDrop); DoNotOptimize(working[i].score); });
+
+    Benchmark("Game::Tick", numGames * 64,
+        [&]() { std::copy(games.begin(), games.end(), working.begin()); },
+        [&](int i) { working[i % numGames].Tick(); });
+
+    // Stack features of the playboard after every placement of a tetromino, as evaluated by the bots
+    std::vector<Grid> afterGrids;
+    for (int id = 1; id <= numTetrominoes; id++) {
+        moves.Generate(stack, Block(id));
+
+        for (int i = 0; i < moves.numPlacements; i++) {
+            Grid after = stack;
+            for (Position item: moves.placements[i].block.GetCellPositions()) {
+                after.SetCell(item.row, item.col, id);
+            }
+            after.ClearFullRows();
+            afterGrids.push_back(after);
+        }
+    }
+
+    int numAfterGrids = (int)afterGrids.size();
+    std::vector<StackFeatures> stackFeatures(numAfterGrids);
+    char kernelName[64];
+    snprintf(kernelName, sizeof(kernelName), "ComputeStackFeatures (%s)", StackFeaturesKernel());
+
+    // Measured per playboard, in calls of 16 playboards
+    Benchmark(kernelName, numAfterGrids, []() {}, [&](int i) {
+        if (i % 16 == 0) {
+            int count = (numAfterGrids - i < 16) ? numAfterGrids - i : 16;
+            ComputeStackFeatures(&afterGrids[i], count, &stackFeatures[i]);
+            DoNotOptimize(stackFeatures[i]);
+        }
+    });
+
+    Benchmark("ComputeStackFeaturesScalar", numAfterGrids, []() {}, [&](int i) {
+        DoNotOptimize(ComputeStackFeaturesScalar(afterGrids[i]));
+    });
+
+    // Stepping many environments with random commands, per environment step
+    const int numEnvs = 1024;
+    VectorEnv envs = VectorEnv(numEnvs, 1);
+    std::vector<uint8_t> envCells(numEnvs * 200);
+    std::vector<int8_t> envPieces(numEnvs * 4);
+    std::vector<int8_t> envHolds(numEnvs);
+    std::vector<int8_t> envQueues(numEnvs * envs.NumPreviews());
+    std::vector<float> envRewards(numEnvs);
+    std::vector<uint8_t> envDones(numEnvs);
+    std::vector<uint8_t> envActions(numEnvs * 16);
+    EnvBuffers buffers = {envCells.data(), envPieces.data(), envHolds.data(), envQueues.data(),
+                          envRewards.data(), envDones.data()};
+
+    for (size_t i = 0; i < envActions.size(); i++) {
+        envActions[i] = (uint8_t)((i * 2654435761u) >> 7) % numEnvActions;
+    }
+
+    envs.Reset(buffers);
+    Benchmark("VectorEnv::Step (per environment)", numEnvs * 16, []() {}, [&](int i) {
+        if (i % numEnvs == 0) {
+            envs.Step(&envActions[i], buffers);
+        }
+    });
+
+    // Placement enumeration from the spawn position
+    Benchmark("MoveGenerator::Generate (empty)", 7 * 64, []() {}, [&](int i) {
+        DoNotOptimize(moves.Generate(Grid(), Block(1 + i % 7)));
+    });
+
+    Benchmark("MoveGenerator::Generate (stack)", 7 * 64, []() {}, [&](int i) {
+        DoNotOptimize(moves.Generate(stack, Block(1 + i % 7)));
+    });
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <cstddef>
+#include <new>
+#include "tetris.h"
+#include "vectorenv.h"
+
+
+// The C buffers are passed straight to `VectorEnv`, so both structures must keep the same layout
+static_assert(sizeof(TetrisBuffers) == sizeof(EnvBuffers), "TetrisBuffers must match EnvBuffers");
+static_assert(offsetof(TetrisBuffers, cells) == offsetof(EnvBuffers, cells), "TetrisBuffers must match EnvBuffers");
+static_assert(offsetof(TetrisBuffers, dones) == offsetof(EnvBuffers, dones), "TetrisBuffers must match EnvBuffers");
+static_assert(TETRIS_NUM_ACTIONS == numEnvActions, "TETRIS_NUM_ACTIONS must match numEnvActions");
+
+struct TetrisEnv {
+    VectorEnv envs;
+};
+
+/// @brief Version of the interface the library was built with, see `TETRIS_ABI_VERSION`.
+uint32_t TetrisAbiVersion(void) {
+    return TETRIS_ABI_VERSION;
+}
+
+/**
+ * @brief Creates a set of environments, see `VectorEnv::VectorEnv()`.
+ * @return The environments, or `NULL` if the arguments are invalid or memory ran out.
+ */
+TetrisEnv *TetrisCreate(int32_t numEnvs, uint32_t seed, int32_t numPreviews, int32_t ticksPerStep,
+                        int32_t maxSteps) {
+    if (numEnvs <= 0 || numPreviews < 1 || numPreviews > maxPreviews || ticksPerStep < 0 || maxSteps < 0) {
+        return nullptr;
+    }
+
+    // No exception may cross the C interface
+    try {
+        return new TetrisEnv{VectorEnv(numEnvs, seed, numPreviews, ticksPerStep, maxSteps)};
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+/// @brief Frees environments created by `TetrisCreate()`; `NULL` is ignored.
+void TetrisDestroy(TetrisEnv *env) {
+    delete env;
+}
+
+/// @brief Number of environments, or `TETRIS_ERROR_ARGUMENT` if `env` is `NULL`.
+int32_t TetrisNumEnvs(const TetrisEnv *env) {
+    return (env != nullptr) ? env -> envs.NumEnvs() : TETRIS_ERROR_ARGUMENT;
+}
+
+/// @brief Upcoming tetrominoes per environment in `TetrisBuffers::queues`.
+int32_t TetrisNumPreviews(const TetrisEnv *env) {
+    return (env != nullptr) ? env -> envs.NumPreviews() : TETRIS_ERROR_ARGUMENT;
+}
+
+/// @brief Restarts every environment and writes their first observations, see `VectorEnv::Reset()`.
+int32_t TetrisReset(TetrisEnv *env, const TetrisBuffers *buffers) {
+    if (env == nullptr || buffers == nullptr) {
+        return TETRIS_ERROR_ARGUMENT;
+    }
+
+    env -> envs.Reset(*reinterpret_cast<const EnvBuffers *>(buffers));
+    return TETRIS_OK;
+}
+
+/**
+ * @brief Applies one action to every environment and writes the results, see `VectorEnv::Step()`.
+ * @param actions `TetrisNumEnvs()` actions, from `0` to `TETRIS_NUM_ACTIONS - 1`.
+ */
+int32_t TetrisStep(TetrisEnv *env, const uint8_t *actions, const TetrisBuffers *buffers) {
+    if (env == nullptr || actions == nullptr || buffers == nullptr) {
+        return TETRIS_ERROR_ARGUMENT;
+    }
+
+    env -> envs.Step(actions, *reinterpret_cast<const EnvBuffers *>(buffers));
+    return TETRIS_OK;
+}
+
+/// @brief Writes the running totals of the current episode of one environment.
+/// @param index Environment, from `0` to `TetrisNumEnvs() - 1`.
+int32_t TetrisQuery(const TetrisEnv *env, int32_t index, TetrisStats *stats) {
+    if (env == nullptr || stats == nullptr || index < 0 || index >= env -> envs.NumEnvs()) {
+        return TETRIS_ERROR_ARGUMENT;
+    }
+
+    const Game &game = env -> envs.GetGame(index);
+    stats -> score = game.score;
+    stats -> linesCleared = game.linesCleared;
+    stats -> comboCount = game.comboCount;
+    stats -> tick = game.CurrentTick();
+    stats -> gameOver = game.gameOver ? 1 : 0;
+    stats -> b2b = game.b2b ? 1 : 0;
+    stats -> tSpinRegular = game.tSpinRegular ? 1 : 0;
+    stats -> tSpinMini = game.tSpinMini ? 1 : 0;
+
+    return TETRIS_OK;
+}
@@ -0,0 +1,74 @@
+#ifndef TETRIS_H
+#define TETRIS_H
+
+// C interface of the game rules, built as `libtetris.so` with `make shared`
+// Only fixed-width types and opaque handles cross the interface, and every observation is written into memory
+// owned by the caller, so other runtimes can map their own arrays onto it without copies
+// Functions returning `int32_t` return `TETRIS_OK` or a negative `TETRIS_ERROR_*` code
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define TETRIS_API __declspec(dllexport)
+#else
+    #define TETRIS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever a function or structure below changes in an incompatible way
+#define TETRIS_ABI_VERSION 1
+
+#define TETRIS_OK 0
+#define TETRIS_ERROR_ARGUMENT -1
+
+// Actions: 0 move left, 1 move right, 2 soft drop, 3 hard drop, 4 rotate clockwise, 5 rotate counter-clockwise, 6 hold
+#define TETRIS_NUM_ACTIONS 7
+
+// Environments stepped together, see `VectorEnv`
+typedef struct TetrisEnv TetrisEnv;
+
+// Caller-owned output buffers, one entry (or row of entries) per environment; any pointer may be NULL
+// `cells`: numEnvs * 200 bytes, row-major playboard, 1 for a filled cell
+// `pieces`: numEnvs * 4, id, rotation state, row and column of the current tetromino
+// `holds`: held tetromino id, 0 for none; `queues`: numEnvs * numPreviews upcoming tetromino ids
+// `rewards`: score gained by the step; `dones`: 1 if the game ended on the step and was restarted
+// Tetromino ids: 1 O, 2 I, 3 S, 4 Z, 5 L, 6 J, 7 T
+typedef struct TetrisBuffers {
+    uint8_t *cells;
+    int8_t *pieces;
+    int8_t *holds;
+    int8_t *queues;
+    float *rewards;
+    uint8_t *dones;
+} TetrisBuffers;
+
+// Running totals of the current episode of an environment
+typedef struct TetrisStats {
+    int64_t score;
+    int32_t linesCleared;
+    int32_t comboCount;
+    uint64_t tick;
+    uint8_t gameOver;
+    uint8_t b2b;
+    uint8_t tSpinRegular;
+    uint8_t tSpinMini;
+} TetrisStats;
+
+TETRIS_API uint32_t TetrisAbiVersion(void);
+TETRIS_API TetrisEnv *TetrisCreate(int32_t numEnvs, uint32_t seed, int32_t numPreviews, int32_t ticksPerStep,
+                                   int32_t maxSteps);
+TETRIS_API void TetrisDestroy(TetrisEnv *env);
+TETRIS_API int32_t TetrisNumEnvs(const TetrisEnv *env);
+TETRIS_API int32_t TetrisNumPreviews(const TetrisEnv *env);
+TETRIS_API int32_t TetrisReset(TetrisEnv *env, const TetrisBuffers *buffers);
+TETRIS_API int32_t TetrisStep(TetrisEnv *env, const uint8_t *actions, const TetrisBuffers *buffers);
+TETRIS_API int32_t TetrisQuery(const TetrisEnv *env, int32_t index, TetrisStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#include <cstring>
+#include "assets.h"
+
+
+// Sound effect files, indexed by `SoundEffect`; `.wav` sources are embedded as QOA, see `tools/bake.cpp`
+const char *soundEffectPaths[numSoundEffects] = {
+    "assets/sfx/move.wav",
+    "assets/sfx/rotate.wav",
+    "assets/sfx/lock.wav",
+    "assets/sfx/lineclear.wav",
+    "assets/sfx/tspin.wav"
+};
+
+// Embedded sound effects, indexed by `SoundEffect`
+const unsigned char *soundAssetData[numSoundEffects] = {
+    moveSoundAssetData, rotateSoundAssetData, lockSoundAssetData, lineClearSoundAssetData, tSpinSoundAssetData
+};
+
+const unsigned int *soundAssetSizes[numSoundEffects] = {
+    &moveSoundAssetSize, &rotateSoundAssetSize, &lockSoundAssetSize, &lineClearSoundAssetSize, &tSpinSoundAssetSize
+};
+
+/// @brief Reads the `int32_t` at `offset` of the baked font.
+static int32_t ReadInt(int offset) {
+    int32_t value;
+    memcpy(&value, fontAssetData + offset, sizeof(value));
+    return value;
+}
+
+/// @brief Reads the `float` at `offset` of the baked font.
+static float ReadFloat(int offset) {
+    float value;
+    memcpy(&value, fontAssetData + offset, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Loads the font from the atlas baked at build time.
+ * @details Only the compressed atlas is inflated and uploaded; no glyph is rasterised at startup.
+ * Falls back to rasterising `fontPath` if no valid atlas was embedded.
+ */
+Font LoadEmbeddedFont() {
+    if (fontAssetSize < (unsigned int)fontAtlasHeaderSize || memcmp(fontAssetData, fontAtlasMagic, 4) != 0 ||
+        fontAssetData[4] != fontAtlasVersion) {
+        return LoadFontEx(fontPath, fontSize, 0, 0);
+    }
+
+    Font font = {};
+    font.baseSize = ReadInt(5);
+    font.glyphCount = ReadInt(9);
+    font.glyphPadding = ReadInt(13);
+
+    Image atlas = {};
+    atlas.width = ReadInt(17);
+    atlas.height = ReadInt(21);
+    atlas.format = ReadInt(25);
+    atlas.mipmaps = 1;
+    int compressedSize = ReadInt(29);
+
+    int glyphsEnd = fontAtlasHeaderSize + font.glyphCount * fontAtlasGlyphSize;
+    if (font.glyphCount <= 0 || (unsigned int)(glyphsEnd + compressedSize) > fontAssetSize) {
+        return LoadFontEx(fontPath, fontSize, 0, 0);
+    }
+
+    int pixelsSize = 0;
+    atlas.data = DecompressData(fontAssetData + glyphsEnd, compressedSize, &pixelsSize);
+    if (atlas.data == nullptr || pixelsSize != GetPixelDataSize(atlas.width, atlas.height, atlas.format)) {
+        MemFree(atlas.data);
+        return LoadFontEx(fontPath, fontSize, 0, 0);
+    }
+
+    font.texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+
+    font.recs = (Rectangle *)MemAlloc(font.glyphCount * sizeof(Rectangle));
+    font.glyphs = (GlyphInfo *)MemAlloc(font.glyphCount * sizeof(GlyphInfo));
+
+    for (int i = 0; i < font.glyphCount; i++) {
+        int offset = fontAtlasHeaderSize + i * fontAtlasGlyphSize;
+
+        font.glyphs[i].value = ReadInt(offset);
+        font.glyphs[i].offsetX = ReadInt(offset + 4);
+        font.glyphs[i].offsetY = ReadInt(offset + 8);
+        font.glyphs[i].advanceX = ReadInt(offset + 12);
+        font.recs[i] = {ReadFloat(offset + 16), ReadFloat(offset + 20), ReadFloat(offset + 24), ReadFloat(offset + 28)};
+    }
+
+    return font;
+}
+
+/// @brief Opens the music stream from the embedded file, which is only decoded as it plays.
+Music LoadEmbeddedMusic() {
+    if (musicAssetSize == 0) {
+        return LoadMusicStream(musicPath);
+    }
+
+    return LoadMusicStreamFromMemory(".mp3", musicAssetData, musicAssetSize);
+}
+
+/// @brief Decodes a sound effect from its embedded QOA file.
+Sound LoadEmbeddedSound(SoundEffect effect) {
+    int index = (int)effect;
+    if (*soundAssetSizes[index] == 0) {
+        return LoadSound(soundEffectPaths[index]);
+    }
+
+    Wave wave = LoadWaveFromMemory(".qoa", soundAssetData[index], *soundAssetSizes[index]);
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+
+    return sound;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <raylib.h>
+#include "audio.h"
+
+
+// Assets embedded into the game at build time by `tools/embed.cpp`, so it starts without reading files
+// An asset whose source file was missing at build time has a size of `0`, and is loaded from its path instead
+extern const unsigned char fontAssetData[];
+extern const unsigned int fontAssetSize;
+extern const unsigned char musicAssetData[];
+extern const unsigned int musicAssetSize;
+extern const unsigned char moveSoundAssetData[];
+extern const unsigned int moveSoundAssetSize;
+extern const unsigned char rotateSoundAssetData[];
+extern const unsigned int rotateSoundAssetSize;
+extern const unsigned char lockSoundAssetData[];
+extern const unsigned int lockSoundAssetSize;
+extern const unsigned char lineClearSoundAssetData[];
+extern const unsigned int lineClearSoundAssetSize;
+extern const unsigned char tSpinSoundAssetData[];
+extern const unsigned int tSpinSoundAssetSize;
+
+// Source files of the assets, and the font size they are rasterised at
+const char fontPath[] = "fonts/Minecraft.ttf";
+const int fontSize = 64;
+const char musicPath[] = "assets/music/bgm.mp3";
+extern const char *soundEffectPaths[numSoundEffects];
+
+// Baked font layout, written by `tools/bake.cpp`: "TFNT", format version, then as `int32_t`s the base size,
+// glyph count, glyph padding, atlas width, height and pixel format and the compressed atlas size, then per glyph
+// the codepoint, offsets and advance as `int32_t`s and its atlas rectangle as 4 `float`s, then the atlas pixels
+// compressed with `CompressData()`; values are in the byte order of the build machine
+const char fontAtlasMagic[4] = {'T', 'F', 'N', 'T'};
+const uint8_t fontAtlasVersion = 1;
+const int fontAtlasHeaderSize = 5 + 7 * 4;
+const int fontAtlasGlyphSize = 4 * 4 + 4 * 4;
+
+Font LoadEmbeddedFont();
+Music LoadEmbeddedMusic();
+Sound LoadEmbeddedSound(SoundEffect effect);
@@ -0,0 +1,138 @@
+#include <chrono>
+#include "assets.h"
+#include "audio.h"
+#include "game.h"
+
+
+/// @brief Initialises a player with no audio thread running.
+AudioPlayer::AudioPlayer() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    running.store(false, std::memory_order_relaxed);
+}
+
+/// @brief Stops the audio thread if it was not stopped with `Stop()`.
+AudioPlayer::~AudioPlayer() {
+    Stop();
+}
+
+/**
+ * @brief Starts the audio thread, which opens the audio device, loads the embedded sounds and plays the music.
+ * @details Returns at once; sounds queued before loading completes play once it does.
+ */
+void AudioPlayer::Start() {
+    Stop();
+
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&AudioPlayer::Run, this);
+}
+
+/**
+ * @brief Queues a sound effect for the audio thread.
+ * @details Never blocks: if the queue is full, the effect is skipped. Only call from one thread.
+ */
+void AudioPlayer::Play(SoundEffect effect) {
+    uint32_t index = head.load(std::memory_order_relaxed);
+    uint32_t next = (index + 1) % audioQueueSize;
+
+    if (next == tail.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    commands[index] = effect;
+    head.store(next, std::memory_order_release);
+}
+
+/// @brief Queues the sound effect of each event taken with `Game::TakeEvents()`.
+void AudioPlayer::PlayEvents(uint8_t events) {
+    if (events & gameEventMove) {
+        Play(SoundEffect::Move);
+    }
+    if (events & gameEventRotate) {
+        Play(SoundEffect::Rotate);
+    }
+    if (events & gameEventLock) {
+        Play(SoundEffect::Lock);
+    }
+    if (events & gameEventTSpin) {
+        Play(SoundEffect::TSpin);
+    } else if (events & gameEventLineClear) {
+        Play(SoundEffect::LineClear);
+    }
+}
+
+/// @brief Stops the audio thread, which unloads every sound and closes the audio device.
+void AudioPlayer::Stop() {
+    if (!thread.joinable()) {
+        return;
+    }
+
+    running.store(false, std::memory_order_release);
+    thread.join();
+}
+
+/**
+ * @brief Audio thread: plays queued effects and keeps the music stream decoded ahead.
+ * @details Each effect is decoded once into a pool of `soundVoices` aliases sharing its samples, played in
+ * turn, so a new play starts at once without cutting off the previous one.
+ */
+void AudioPlayer::Run() {
+    InitAudioDevice();
+
+    Sound voices[numSoundEffects][soundVoices] = {};
+    int nextVoice[numSoundEffects] = {};
+
+    for (int effect = 0; effect < numSoundEffects; effect++) {
+        voices[effect][0] = LoadEmbeddedSound((SoundEffect)effect);
+
+        if (IsSoundReady(voices[effect][0])) {
+            for (int voice = 1; voice < soundVoices; voice++) {
+                voices[effect][voice] = LoadSoundAlias(voices[effect][0]);
+            }
+        }
+    }
+
+    SetAudioStreamBufferSizeDefault(musicBufferFrames);
+    Music music = LoadEmbeddedMusic();
+    bool hasMusic = IsMusicReady(music);
+    if (hasMusic) {
+        PlayMusicStream(music);
+    }
+
+    while (running.load(std::memory_order_acquire)) {
+        uint32_t index = tail.load(std::memory_order_relaxed);
+        uint32_t end = head.load(std::memory_order_acquire);
+
+        for (; index != end; index = (index + 1) % audioQueueSize) {
+            int effect = (int)commands[index];
+
+            if (IsSoundReady(voices[effect][0])) {
+                PlaySound(voices[effect][nextVoice[effect]]);
+                nextVoice[effect] = (nextVoice[effect] + 1) % soundVoices;
+            }
+        }
+
+        tail.store(end, std::memory_order_release);
+
+        if (hasMusic) {
+            UpdateMusicStream(music);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(audioPollMilliseconds));
+    }
+
+    if (hasMusic) {
+        UnloadMusicStream(music);
+    }
+
+    for (int effect = 0; effect < numSoundEffects; effect++) {
+        if (IsSoundReady(voices[effect][0])) {
+            for (int voice = 1; voice < soundVoices; voice++) {
+                UnloadSoundAlias(voices[effect][voice]);
+            }
+            UnloadSound(voices[effect][0]);
+        }
+    }
+
+    CloseAudioDevice();
+}
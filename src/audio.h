@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <raylib.h>
+
+
+// Short sound effects, fully decoded when the audio thread starts, see `LoadEmbeddedSound()`
+enum class SoundEffect : uint8_t {
+    Move,
+    Rotate,
+    Lock,
+    LineClear,
+    TSpin
+};
+
+const int numSoundEffects = 5;
+
+// Voices per effect, so an effect can overlap itself, e.g. when auto-repeat moves every tick
+const int soundVoices = 4;
+
+// Commands queued for the audio thread; the ring holds `audioQueueSize - 1`
+const int audioQueueSize = 64;
+
+// Music frames decoded ahead in each stream buffer, about 0.37 s at 44.1 kHz, and how often the audio thread wakes
+const int musicBufferFrames = 16384;
+const int audioPollMilliseconds = 4;
+
+// Plays music and sound effects on a dedicated thread, so decoding never delays a frame
+// The thread owns raylib's audio device; the window thread only queues commands, without locks or waiting
+class AudioPlayer {
+    public:
+        AudioPlayer();
+        ~AudioPlayer();
+        void Start();
+        void Play(SoundEffect effect);
+        void PlayEvents(uint8_t events);
+        void Stop();
+
+    private:
+        SoundEffect commands[audioQueueSize];
+        alignas(64) std::atomic<uint32_t> head;
+        alignas(64) std::atomic<uint32_t> tail;
+        std::atomic<bool> running;
+        std::thread thread;
+        void Run();
+};
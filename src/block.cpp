@@ -1,117 +1,95 @@
 #include "block.h"
+#include "grid.h"
 
 
-// const vector declarations for wall kick tests
-const std::vector<std::vector<Position>> defaultClockwise = {
+// const array declarations for wall kick tests, indexed by the rotation state after rotating
+constexpr Position defaultClockwise[4][numKickTests] = {
     {Position(0, 0), Position(0, -1), Position(1, -1), Position(-2, 0), Position(-2, -1)},
     {Position(0, 0), Position(0, -1), Position(-1, -1), Position(2, 0), Position(2, -1)},
     {Position(0, 0), Position(0, 1), Position(1, 1), Position(-2, 0), Position(-2, 1)},
     {Position(0, 0), Position(0, 1), Position(-1, 1), Position(2, 0), Position(2, 1)},
 };
 
-const std::vector<std::vector<Position>> defaultCounterClockwise = {
+constexpr Position defaultCounterClockwise[4][numKickTests] = {
     {Position(0, 0), Position(0, 1), Position(1, 1), Position(-2, 0), Position(-2, 1)},
     {Position(0, 0), Position(0, -1), Position(-1, -1), Position(2, 0), Position(2, -1)},
     {Position(0, 0), Position(0, -1), Position(1, -1), Position(-2, 0), Position(-2, -1)},
     {Position(0, 0), Position(0, 1), Position(-1, 1), Position(2, 0), Position(2, 1)},
 };
 
-const std::vector<std::vector<Position>> iBlockClockwise = {
+constexpr Position iBlockClockwise[4][numKickTests] = {
     {Position(0, 0), Position(0, 1), Position(0, -2), Position(2, 1), Position(-1, -2)},
     {Position(0, 0), Position(0, -2), Position(0, 1), Position(1, -2), Position(-2, 1)},
     {Position(0, 0), Position(0, -1), Position(0, 2), Position(-2, -1), Position(1, 2)},
     {Position(0, 0), Position(0, 2), Position(0, -1), Position(-1, 2), Position(2, -1)},
 };
 
-const std::vector<std::vector<Position>> iBlockCounterClockwise = {
+constexpr Position iBlockCounterClockwise[4][numKickTests] = {
     {Position(0, 0), Position(0, 2), Position(0, -1), Position(-1, 2), Position(2, -1)},
     {Position(0, 0), Position(0, 1), Position(0, -2), Position(2, 1), Position(-1, -2)},
     {Position(0, 0), Position(0, -2), Position(0, 1), Position(1, -2), Position(-2, 1)},
     {Position(0, 0), Position(0, -1), Position(0, 2), Position(-2, -1), Position(1, 2)},
 };
 
-const std::vector<Position> oBlock = {
-    {Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)}
+constexpr Position oBlock[numKickTests] = {
+    Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0), Position(0, 0)
 };
 
-/// @brief Initialises variables relating to the tetrominoes.
-/// @details Inclusive of `cellSize` in pixels, rotation state, colours (both regular and ghost blocks) and offsets.
+/// @brief Initialises an empty block, i.e. `id == 0`, as used for an empty hold.
 Block::Block() {
-    cellSize = 33;
+    id = 0;
     rotationState = 0;
-    colours = GetCellColours();
-    ghostColours = GetGhostColours();
-    rowOffset = 0;
-    colOffset = 0;
+    row = 0;
+    col = 0;
 }
 
-/**
- * @brief Draws the block at the specific point on the playboard with the appropriate colour.
- * @param offsetX Offset for column in pixels (default: 181 to account for border and hold).
- * @param offsetY Offset for row in pixels (default: 16 to account for border around playboard).
- */
-void Block::Draw(int offsetX, int offsetY) {
-    std::vector<Position> tiles = GetCellPositions();
-
-    for (Position item: tiles) {
-        DrawRectangle(item.col * cellSize + offsetX, item.row * cellSize + offsetY, cellSize - 1, cellSize - 1, colours[id]);
-    }
-}
-
-/**
- * @brief Draws the "ghost block" at the specific point on the playboard with the appropriate colour.
- * @details Highlights lowest possible legal position of the tetromino if the player were to "hard drop".
- * Colours are just the original tetromino colours but with decreased opacity.
- * @param ghostRow Offset for row in actual tiles (of the playboard).
- */
-void Block::DrawGhost(int ghostRow) {
-    std::vector<Position> tiles = GetCellPositions();
-
-    for (Position item: tiles) {
-        DrawRectangle(item.col * cellSize + 181, (item.row + ghostRow) * cellSize + 16, cellSize - 1, cellSize - 1, ghostColours[id]);
-    }
+/// @brief Initialises a tetromino at its spawn position at the top of the playboard.
+/// @param id Tetromino id, see `tetrominoes.h`.
+Block::Block(int id) {
+    this -> id = (int8_t)id;
+    rotationState = 0;
+    row = (int8_t)spawnOffsets[id].row;
+    col = (int8_t)spawnOffsets[id].col;
 }
 
 /**
  * @brief Moves tetromino around the playboard.
- * @details Position of the tetromino is calculated by adding/subtracting the offsets to/from
- * the original position as defined in `tetrominoes.cpp`.
- * It is also used to position the tetromino appropriately when it spawns at the top of the playboard.
+ * @details Position of the tetromino is calculated by adding the row and column of its
+ * bounding box to the original position as defined in `tetrominoes.h`.
  * @param rows The row offset.
  * @param cols The column offset.
  */
 void Block::Move(int rows, int cols) {
-    rowOffset += rows;
-    colOffset += cols;
+    row += rows;
+    col += cols;
 }
 
 /**
  * @brief Queries the position of the tetromino on the playboard.
- * @details The current position is obtained from adding the original defined position in `tetrominoes.cpp`
+ * @details The current position is obtained from adding the original defined position in `tetrominoes.h`
  * to the row and column offsets.
- * @return A vector of `Position` containing coordinates for each block in the tetromino.
+ * @return An array of `Position` containing coordinates for each block in the tetromino.
  */
-std::vector<Position> Block::GetCellPositions() {
-    std::vector<Position> tiles = cells[rotationState];
-    std::vector<Position> movedTiles;
-
-    for (Position item: tiles) {
-        Position posNew = Position(item.row + rowOffset, item.col + colOffset);
-        movedTiles.push_back(posNew);
-    }
-
-    return movedTiles;
+std::array<Position, 4> Block::GetCellPositions() const {
+    const Position *tiles = tetrominoCells[id][rotationState];
+
+    return {{
+        Position(tiles[0].row + row, tiles[0].col + col),
+        Position(tiles[1].row + row, tiles[1].col + col),
+        Position(tiles[2].row + row, tiles[2].col + col),
+        Position(tiles[3].row + row, tiles[3].col + col),
+    }};
 }
 
 /**
  * @brief Rotates the current tetromino clockwise.
- * @details Handles "wall kicks" through the defined `const` global variables at the top of this document.
- * @return A vector<Position> that handles each "wall kick" case.
+ * @details Handles "wall kicks" through the defined `const` global arrays at the top of this document.
+ * @return The `numKickTests` "wall kick" offsets to try, in order.
  */
-std::vector<Position> Block::RotateClockwise() {
+const Position *Block::RotateClockwise() {
     rotationState++;
 
-    if (rotationState >= (int)cells.size()) {
+    if (rotationState >= tetrominoRotations[id]) {
         rotationState = 0;
     }
 
@@ -129,14 +107,14 @@ std::vector<Position> Block::RotateClockwise() {
 
 /**
  * @brief Rotates the current tetromino counterclockwise.
- * @details Handles "wall kicks" through the defined `const` global variables at the top of this document.
- * @return A vector<Position> that handles each "wall kick" case.
+ * @details Handles "wall kicks" through the defined `const` global arrays at the top of this document.
+ * @return The `numKickTests` "wall kick" offsets to try, in order.
  */
-std::vector<Position> Block::RotateCounterClockwise() {
+const Position *Block::RotateCounterClockwise() {
     rotationState--;
-    
+
     if (rotationState < 0) {
-        rotationState = (int)cells.size() - 1;
+        rotationState = tetrominoRotations[id] - 1;
     }
 
     switch(id) {
@@ -149,4 +127,32 @@ std::vector<Position> Block::RotateCounterClockwise() {
         default:
             return defaultCounterClockwise[rotationState];
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Rotates the tetromino on the playboard, applying the "wall kick" tests in order.
+ * @details The first test that does not collide with the grid is used. If every test fails,
+ * the tetromino is left unrotated.
+ * @param grid Playboard to test collisions against.
+ * @param clockwise `true` to rotate clockwise, `false` to rotate counterclockwise.
+ * @return Index of the wall kick test used, or `-1` if the rotation failed.
+ */
+int Block::Rotate(const Grid &grid, bool clockwise) {
+    const Position *wallKickCases = clockwise ? RotateClockwise() : RotateCounterClockwise();
+
+    for (int i = 0; i < numKickTests; i++) {
+        if (!grid.Collides(row + wallKickCases[i].row, col + wallKickCases[i].col, GetShape())) {
+            Move(wallKickCases[i].row, wallKickCases[i].col);
+            return i;
+        }
+    }
+
+    // Test failed: Undo rotation
+    if (clockwise) {
+        RotateCounterClockwise();
+    } else {
+        RotateClockwise();
+    }
+
+    return -1;
+}
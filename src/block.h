@@ -1,28 +1,42 @@
 #pragma once
 
-#include <vector>
-#include <map>
+#include <array>
+#include <cstdint>
 #include "position.h"
-#include "colours.h"
+#include "tetrominoes.h"
 
 
+// Number of wall kick tests per rotation
+const int numKickTests = 5;
+
+class Grid;
+
 class Block {
     public:
-        int id;
-        int rotationState;
-        std::map<int, std::vector<Position>> cells;
+        int8_t id;
+        int8_t rotationState;
+        int8_t row;
+        int8_t col;
         Block();
-        void Draw(int offsetX, int offsetY);
-        void DrawGhost(int ghostRow);
+        Block(int id);
         void Move(int rows, int cols);
-        std::vector<Position> GetCellPositions();
-        std::vector<Position> RotateClockwise();
-        std::vector<Position> RotateCounterClockwise();
+        std::array<Position, 4> GetCellPositions() const;
+        const uint16_t *GetShape() const;
+        const int8_t *GetBottoms() const;
+        const Position *RotateClockwise();
+        const Position *RotateCounterClockwise();
+        int Rotate(const Grid &grid, bool clockwise);
+};
+
+/// @brief Queries the occupancy mask of the tetromino for bitboard collision tests.
+/// @details The masks are shared by every block in the same rotation state, see `tetrominoes.h`.
+/// @return The mask of each bounding box row, where bit `n` is box column `n`.
+inline const uint16_t *Block::GetShape() const {
+    return tetrominoShapes.masks[id][rotationState];
+}
 
-    private:
-        int cellSize;
-        std::vector<Color> colours;
-        std::vector<Color> ghostColours;
-        int rowOffset;
-        int colOffset;
-};
\ No newline at end of file
+/// @brief Queries the lowest tile of each bounding box column for drop distance calculations.
+/// @return The lowest occupied bounding box row of each box column, `-1` if the column is empty.
+inline const int8_t *Block::GetBottoms() const {
+    return tetrominoShapes.bottoms[id][rotationState];
+}
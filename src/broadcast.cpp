@@ -0,0 +1,371 @@
+#include <cstring>
+#include <new>
+#include "broadcast.h"
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+/**
+ * @brief Writes the bytes of `now` that differ from `base` as runs of offset, length and bytes.
+ * @details Runs separated by 2 unchanged bytes or fewer are merged, since a new run costs as much.
+ * @return Length of the payload, including the flags byte.
+ */
+static int EncodeFrame(const SpectatorSnapshot &base, const SpectatorSnapshot &now, uint8_t flags, uint8_t out[]) {
+    const uint8_t *from = (const uint8_t *)&base;
+    const uint8_t *to = (const uint8_t *)&now;
+    const int size = sizeof(SpectatorSnapshot);
+
+    int length = 0;
+    out[length++] = flags;
+
+    int i = 0;
+    while (i < size) {
+        if (from[i] == to[i]) {
+            i++;
+            continue;
+        }
+
+        int end = i + 1;
+        for (int j = end; j < size && j - end < 3; j++) {
+            if (from[j] != to[j]) {
+                end = j + 1;
+            }
+        }
+
+        out[length++] = (uint8_t)i;
+        out[length++] = (uint8_t)(end - i);
+        memcpy(out + length, to + i, end - i);
+        length += end - i;
+        i = end;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Copies the state spectators see from a game.
+ * @param game Game to copy.
+ * @param snapshot Snapshot to overwrite.
+ */
+void CaptureSnapshot(const Game &game, SpectatorSnapshot &snapshot) {
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    snapshot.tick = game.CurrentTick();
+    snapshot.score = game.score;
+    snapshot.linesCleared = game.linesCleared;
+    snapshot.comboCount = game.comboCount;
+
+    const Grid &grid = game.GetGrid();
+    for (int row = 0; row < 20; row++) {
+        snapshot.rows[row] = (grid.rows[row] >> wallBits) & 0x3FF;
+    }
+
+    const Block &current = game.GetCurrentBlock();
+    snapshot.piece[0] = current.id;
+    snapshot.piece[1] = current.rotationState;
+    snapshot.piece[2] = current.row;
+    snapshot.piece[3] = current.col;
+    snapshot.ghostRow = game.GhostRow();
+    snapshot.hold = game.GetHeldBlock().id;
+
+    snapshot.flags = (game.gameOver ? spectatorGameOver : 0) | (game.b2b ? spectatorB2B : 0) |
+                     (game.IsB2BActive() ? spectatorB2BActive : 0) |
+                     (game.tSpinRegular ? spectatorTSpinRegular : 0) | (game.tSpinMini ? spectatorTSpinMini : 0);
+
+    snapshot.numPreviews = game.NumPreviews();
+    for (int i = 0; i < snapshot.numPreviews; i++) {
+        snapshot.queue[i] = game.Preview(i);
+    }
+}
+
+/// @brief Initialises a broadcast with no shared memory open.
+SpectatorBroadcast::SpectatorBroadcast() {
+    ring = nullptr;
+    frames = 0;
+    memset(&previous, 0, sizeof(previous));
+}
+
+/// @brief Removes the shared memory if it was not closed with `Close()`.
+SpectatorBroadcast::~SpectatorBroadcast() {
+    Close();
+}
+
+/**
+ * @brief Creates the shared memory object readers follow.
+ * @details An existing object of the same name is replaced. Not supported on Windows.
+ * @param name Name of the object, e.g. `spectatorName`.
+ * @return `true` if the object was created, `false` otherwise.
+ */
+bool SpectatorBroadcast::Open(const char *name) {
+#if defined(_WIN32)
+    (void)name;
+    return false;
+#else
+    Close();
+
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(SpectatorRing)) == 0) {
+        memory = mmap(nullptr, sizeof(SpectatorRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+
+    ring = new (memory) SpectatorRing();
+    ring -> version = spectatorVersion;
+    ring -> published.store(0, std::memory_order_relaxed);
+    for (SpectatorSlot &slot: ring -> slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    // Readers check the magic last, once the rest of the header is visible
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(ring -> magic, spectatorMagic, sizeof(spectatorMagic));
+
+    this -> name = name;
+    frames = 0;
+    memset(&previous, 0, sizeof(previous));
+
+    return true;
+#endif
+}
+
+/// @brief Checks if snapshots are being published.
+bool SpectatorBroadcast::IsOpen() const {
+    return ring != nullptr;
+}
+
+/**
+ * @brief Publishes the state of the game as the next frame.
+ * @details The slot is marked as being written, filled with the changes since the previous snapshot, then
+ * marked as complete, so readers never wait on the game and detect a frame overwritten while they copied it.
+ * Does nothing if the broadcast is not open.
+ * @param game Game to publish, usually after each `Game::Tick()`.
+ */
+void SpectatorBroadcast::Publish(const Game &game) {
+    if (ring == nullptr) {
+        return;
+    }
+
+    SpectatorSnapshot snapshot;
+    CaptureSnapshot(game, snapshot);
+
+    bool keyframe = frames % spectatorKeyframeInterval == 0;
+    SpectatorSnapshot empty;
+    memset(&empty, 0, sizeof(empty));
+
+    SpectatorSlot &slot = ring -> slots[frames % spectatorSlots];
+    slot.sequence.store(2 * frames + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.length = EncodeFrame(keyframe ? empty : previous, snapshot, keyframe ? spectatorKeyframe : 0, slot.payload);
+
+    slot.sequence.store(2 * frames + 2, std::memory_order_release);
+    ring -> published.store(frames + 1, std::memory_order_release);
+
+    previous = snapshot;
+    frames++;
+}
+
+/// @brief Unmaps and removes the shared memory; readers keep their mapping but see no further frames.
+void SpectatorBroadcast::Close() {
+#if !defined(_WIN32)
+    if (ring != nullptr) {
+        munmap(ring, sizeof(SpectatorRing));
+        shm_unlink(name.c_str());
+        ring = nullptr;
+    }
+#endif
+}
+
+/// @brief Initialises a reader with no shared memory open.
+SpectatorReader::SpectatorReader() {
+    ring = nullptr;
+    next = 0;
+    dropped = 0;
+    synced = false;
+    memset(&current, 0, sizeof(current));
+}
+
+/// @brief Unmaps the shared memory.
+SpectatorReader::~SpectatorReader() {
+    Close();
+}
+
+/**
+ * @brief Maps the shared memory of a running broadcast, read-only.
+ * @details Reading starts from the latest keyframe still in the ring.
+ * @param name Name of the object, e.g. `spectatorName`.
+ * @return `true` if a broadcast of this version was found, `false` otherwise.
+ */
+bool SpectatorReader::Open(const char *name) {
+#if defined(_WIN32)
+    (void)name;
+    return false;
+#else
+    Close();
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    void *memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(SpectatorRing)) {
+        memory = mmap(nullptr, sizeof(SpectatorRing), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    ring = (const SpectatorRing *)memory;
+    if (memcmp(ring -> magic, spectatorMagic, sizeof(spectatorMagic)) != 0 || ring -> version != spectatorVersion) {
+        Close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    uint64_t published = ring -> published.load(std::memory_order_acquire);
+    next = (published > 0) ? (published - 1) / spectatorKeyframeInterval * spectatorKeyframeInterval : 0;
+    dropped = 0;
+    synced = false;
+
+    return true;
+#endif
+}
+
+/// @brief Checks if a broadcast is being followed.
+bool SpectatorReader::IsOpen() const {
+    return ring != nullptr;
+}
+
+/**
+ * @brief Reads the next frame.
+ * @details A reader that falls a whole ring behind skips to the latest keyframe, and counts the frames it
+ * missed in `Dropped()`. Call until it returns `false` to catch up to the latest snapshot.
+ * @param snapshot Snapshot to overwrite with the state after the frame.
+ * @return `true` if a frame was read, `false` if no new frame has been published yet.
+ */
+bool SpectatorReader::Next(SpectatorSnapshot &snapshot) {
+    if (ring == nullptr) {
+        return false;
+    }
+
+    while (true) {
+        uint64_t published = ring -> published.load(std::memory_order_acquire);
+        if (next >= published) {
+            return false;
+        }
+
+        // Too far behind: the frame may already be overwritten
+        if (published - next >= spectatorSlots) {
+            uint64_t keyframe = (published - 1) / spectatorKeyframeInterval * spectatorKeyframeInterval;
+            dropped += keyframe - next;
+            next = keyframe;
+            synced = false;
+        }
+
+        const SpectatorSlot &slot = ring -> slots[next % spectatorSlots];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        uint8_t payload[spectatorPayloadSize];
+        int length = slot.length;
+        length = (length > spectatorPayloadSize) ? spectatorPayloadSize : length;
+        memcpy(payload, slot.payload, length);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence != 2 * next + 2 || slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            // Overwritten while copying: skip to the latest keyframe
+            uint64_t keyframe = (ring -> published.load(std::memory_order_acquire) - 1) /
+                                spectatorKeyframeInterval * spectatorKeyframeInterval;
+            dropped += (keyframe > next) ? keyframe - next : 1;
+            next = (keyframe > next) ? keyframe : next + 1;
+            synced = false;
+            continue;
+        }
+
+        next++;
+
+        // Deltas only apply on top of the frame before them
+        bool keyframe = length > 0 && (payload[0] & spectatorKeyframe);
+        if (!keyframe && !synced) {
+            dropped++;
+            continue;
+        }
+
+        if (!Decode(payload, length)) {
+            dropped++;
+            synced = false;
+            continue;
+        }
+
+        synced = true;
+        snapshot = current;
+        return true;
+    }
+}
+
+/// @brief Applies a frame payload to the current snapshot.
+/// @return `false` if the payload is malformed.
+bool SpectatorReader::Decode(const uint8_t payload[], int length) {
+    if (length < 1) {
+        return false;
+    }
+
+    SpectatorSnapshot result = current;
+    if (payload[0] & spectatorKeyframe) {
+        memset(&result, 0, sizeof(result));
+    }
+
+    uint8_t *bytes = (uint8_t *)&result;
+    int i = 1;
+    while (i < length) {
+        if (i + 2 > length) {
+            return false;
+        }
+
+        int offset = payload[i];
+        int size = payload[i + 1];
+        if (offset + size > (int)sizeof(SpectatorSnapshot) || i + 2 + size > length) {
+            return false;
+        }
+
+        memcpy(bytes + offset, payload + i + 2, size);
+        i += 2 + size;
+    }
+
+    current = result;
+    return true;
+}
+
+/// @brief Frames skipped because this reader fell behind or joined between keyframes.
+uint64_t SpectatorReader::Dropped() const {
+    return dropped;
+}
+
+/// @brief Unmaps the shared memory.
+void SpectatorReader::Close() {
+#if !defined(_WIN32)
+    if (ring != nullptr) {
+        munmap((void *)ring, sizeof(SpectatorRing));
+        ring = nullptr;
+    }
+#endif
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "game.h"
+
+
+// Shared memory object the running game publishes to, see `tools/spectate.cpp`
+const char spectatorName[] = "/tetris-spectator";
+
+// Ring layout: "TSPC", format version, then `spectatorSlots` frames, the oldest overwritten first
+// A keyframe every `spectatorKeyframeInterval` frames lets readers that join late or fall behind resync
+const char spectatorMagic[4] = {'T', 'S', 'P', 'C'};
+const uint32_t spectatorVersion = 1;
+const int spectatorSlots = 256;
+const int spectatorKeyframeInterval = 60;
+
+// `SpectatorSnapshot::flags` bits
+const uint8_t spectatorGameOver = 1 << 0;
+const uint8_t spectatorB2B = 1 << 1;            // the last clear was a back-to-back
+const uint8_t spectatorB2BActive = 1 << 2;      // the next difficult clear will be a back-to-back
+const uint8_t spectatorTSpinRegular = 1 << 3;
+const uint8_t spectatorTSpinMini = 1 << 4;
+
+// State of the game after a tick, as seen by spectators
+// Frames are encoded as the bytes that changed since the previous snapshot, so the layout has no padding
+struct SpectatorSnapshot {
+    uint64_t tick;
+    int64_t score;
+    int32_t linesCleared;
+    int32_t comboCount;
+    uint16_t rows[20];              // bit `col` is column `col`, `1` for a filled cell
+    int8_t piece[4];                // id, rotation state, row and column of the current tetromino
+    int8_t ghostRow;
+    int8_t hold;
+    uint8_t flags;
+    uint8_t numPreviews;
+    int8_t queue[pieceQueueSize];   // the first `numPreviews` are upcoming tetromino ids
+};
+
+static_assert(sizeof(SpectatorSnapshot) == 88, "SpectatorSnapshot must not be padded");
+
+// Frame payload: flags byte (`1` for a keyframe), then runs of changed bytes, each as offset, length and bytes
+// A keyframe is encoded against a zeroed snapshot; the worst case is one run per 4 bytes
+const uint8_t spectatorKeyframe = 1;
+const int spectatorPayloadSize = 118;
+
+static_assert(spectatorPayloadSize >= (int)sizeof(SpectatorSnapshot) + 3, "Frames must fit in a slot");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Sequences are shared between processes and must be lock-free");
+
+// One frame; `sequence` is `2 * frame + 1` while it is written and `2 * frame + 2` once complete
+struct alignas(64) SpectatorSlot {
+    std::atomic<uint64_t> sequence;
+    uint16_t length;
+    uint8_t payload[spectatorPayloadSize];
+};
+
+// Layout of the shared memory object; only the game writes to it
+struct SpectatorRing {
+    char magic[4];
+    uint32_t version;
+    alignas(64) std::atomic<uint64_t> published;    // frames published so far
+    SpectatorSlot slots[spectatorSlots];
+};
+
+void CaptureSnapshot(const Game &game, SpectatorSnapshot &snapshot);
+
+// Publishes a snapshot of the game every tick for overlays and commentary tools
+class SpectatorBroadcast {
+    public:
+        SpectatorBroadcast();
+        ~SpectatorBroadcast();
+        bool Open(const char *name);
+        bool IsOpen() const;
+        void Publish(const Game &game);
+        void Close();
+
+    private:
+        SpectatorRing *ring;
+        std::string name;
+        SpectatorSnapshot previous;
+        uint64_t frames;
+};
+
+// Follows the frames of a `SpectatorBroadcast`, from another process; any number of readers can follow at once
+class SpectatorReader {
+    public:
+        SpectatorReader();
+        ~SpectatorReader();
+        bool Open(const char *name);
+        bool IsOpen() const;
+        bool Next(SpectatorSnapshot &snapshot);
+        uint64_t Dropped() const;
+        void Close();
+
+    private:
+        const SpectatorRing *ring;
+        SpectatorSnapshot current;
+        uint64_t next;
+        uint64_t dropped;
+        bool synced;
+        bool Decode(const uint8_t payload[], int length);
+};
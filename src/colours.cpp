@@ -1,4 +1,3 @@
-#include <vector>
 #include "colours.h"
 
 
@@ -29,14 +28,8 @@ const Color lightPurple = {66, 50, 130, 255};
 const Color darkerPurple = {24, 13, 59, 255};
 const Color lighterPurple = {90, 72, 163, 255};
 
-/// @brief Fetches colours of tetrominoes.
-/// @return Returns a vector of `Color` with an index corresponding to the `id`s of each tetromino.
-std::vector<Color> GetCellColours() {
-    return {empty, yellow, cyan, red, green, orange, blue, purple};
-}
+// Tetromino colours indexed by `id`
+const Color cellColours[8] = {empty, yellow, cyan, red, green, orange, blue, purple};
 
-/// @brief Fetches colours of ghost tetrominoes.
-/// @return Returns a vector of `Color` with an index corresponding to the `id`s of each tetromino.
-std::vector<Color> GetGhostColours() {
-    return {empty, ghostYellow, ghostCyan, ghostRed, ghostGreen, ghostOrange, ghostBlue, ghostPurple};
-}
\ No newline at end of file
+// Ghost tetromino colours indexed by `id`
+const Color ghostCellColours[8] = {empty, ghostYellow, ghostCyan, ghostRed, ghostGreen, ghostOrange, ghostBlue, ghostPurple};
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <vector>
 #include <raylib.h>
 
 
@@ -31,5 +30,6 @@ extern const Color lightPurple;
 extern const Color darkerPurple;
 extern const Color lighterPurple;
 
-std::vector<Color> GetCellColours();
-std::vector<Color> GetGhostColours();
\ No newline at end of file
+// Colours indexed by tetromino id, `0` being an empty cell
+extern const Color cellColours[8];
+extern const Color ghostCellColours[8];
\ No newline at end of file
@@ -1,15 +1,36 @@
-#include <random>
 #include "game.h"
+#include "profiler.h"
+#include "replay.h"
+#include "scoring.h"
+#include "trace.h"
+#include "zobrist.h"
 
 
+// Ticks between gravity steps for levels 1 to 15
+// Derived from (0.8 - (level - 1) * 0.007)^(level - 1) seconds per tile, rounded up to whole ticks
+const int gravityTicks[15] = {60, 48, 38, 29, 22, 16, 12, 9, 6, 4, 3, 2, 2, 1, 1};
+
+// Maximum lock delay (0.5 seconds)
+const int maxLockDelayTicks = 30;
+
+// Seed used when none is given; every session deals the same sequence, as with the unseeded `rand()` it replaces
+const uint32_t defaultSeed = 5489u;
+
+/// @brief Initialises the game with the default seed.
+Game::Game() : Game(defaultSeed) {
+}
+
 /// @brief Initialises the game.
-/// @details Initialises grid, blocks, score, sound effects and audio, as well as game state.
-Game::Game() {
+/// @details Initialises grid, blocks, score and simulation clock, as well as game state.
+/// @param seed Seed of the randomizer that deals the tetrominoes.
+/// Games created with the same seed deal the same sequence of tetrominoes.
+/// @param numPreviews Number of upcoming tetrominoes shown in the "Next" panel, up to `maxPreviews`.
+Game::Game(uint32_t seed, int numPreviews) {
     // Initialising grid and blocks
     grid = Grid();
-    blocks = GetAllBlocks();
-    current = GetRandomBlock();
-    next = GetRandomBlock();
+    this -> seed = seed;
+    queue.Seed(seed, numPreviews);
+    current = NextBlock();
     hold.id = 0;
 
     // Game state
@@ -18,197 +39,337 @@ Game::Game() {
     
     // Initialising game attributes and score
     gameOver = false;
+    handling = defaultHandling;
+    recorder = nullptr;
+    trace = nullptr;
     lastMoveRotate = false;
     score = 0;
     linesCleared = 0;
     lockResets = 15;
     lockDelayActive = false;
-    lockDelayStartTime = 0.0;
+    lockDelayStartTick = 0;
     justHeld = false;
     comboCount = -1;
     b2bDifficult = false;
     tSpinRegular = false;
     tSpinMini = false;
     b2b = false;
-
-    // Initialising audio
-    InitAudioDevice();
-    music = LoadMusicStream("assets/music/bgm.mp3");
-    PlayMusicStream(music);
+    events = 0;
+
+    // Initialising simulation clock
+    currentTick = 0;
+    lastGravityTick = 0;
+
+    // Initialising held inputs
+    leftHeld = false;
+    rightHeld = false;
+    softDropHeld = false;
+    shiftDirection = 0;
+    shiftTicks = 0;
+    softDropHeldTicks = 0;
 }
 
-/// @brief Destructor for the Game class.
-/// @details Unloads the music stream and closes the audio device to free resources.
-Game::~Game() {
-    UnloadMusicStream(music);
-    CloseAudioDevice();
-}
 /**
- * @brief Randomly chooses a block from a vector of all block possibilities.
- * @return The randomly chosen block.
- * @details If the blocks vector is empty, it will refill it with all available blocks.
- * The function uses `rand()` to generate a random index to select a block.
- * The selected block is then removed from the vector to ensure repeated block spawns are impossible.
+ * @brief Deals the tetromino at the front of the queue.
+ * @details Tetrominoes are dealt from a seeded 7-bag, see `PieceQueue`, so that games are
+ * reproducible from their seed and independent of each other across threads.
+ * @return The dealt block at its spawn position.
  */
-Block Game::GetRandomBlock() {
+Block Game::NextBlock() {
     // Reset max lock resets
     lockResets = 15;
 
-    // When blocks vec is empty
-    if (blocks.empty()) {
-        blocks = GetAllBlocks();
+    return Block(queue.Pop());
+}
+
+/**
+ * @brief Applies a single player command to the game.
+ * @details Follows typical tetris controls, with commands to move, rotate, drop,
+ * hold and restart the game. Only `Command::Restart` is accepted once the game is over.
+ * @param command The command to apply.
+ */
+void Game::Execute(Command command) {
+    if (gameOver && command != Command::Restart) {
+        return;
     }
 
-    int randomIdx = rand() % blocks.size();
-    Block block = blocks[randomIdx];
-    blocks.erase(blocks.begin() + randomIdx);
+    if (recorder != nullptr) {
+        recorder -> Record(currentTick, (uint8_t)command);
+    }
 
-    return block;
-}
+    switch(command) {
+        case Command::MoveLeft:
+            MoveLeft();
+            break;
 
-/// @brief Generates a vector containing all possible tetrominoes.
-/// @return Returns a vector of all possible tetrominoes.
-std::vector<Block> Game::GetAllBlocks() {
-    return {OBlock(), IBlock(), SBlock(), ZBlock(), LBlock(), JBlock(), TBlock()};
-}
+        case Command::MoveRight:
+            MoveRight();
+            break;
 
-/**
- * @brief Draws all objects in the game.
- * @details Aforementioned objects include the game grid, the current block,
- * the next block and the ghost block.
- */
-void Game::Draw() {
-    DrawRectangle(173, 8, 346, 676, lighterPurple);
-    DrawRectangle(181, 16, 330, 660, darkPurple);
-    grid.Draw();
-    current.Draw(181, 16);
-
-    switch(next.id) {
-        case 1:
-            next.Draw(387 + 50, 48 + 50);
+        case Command::SoftDrop:
+            if (!IsGravityStronger()) {
+                MoveDown(true);
+            }
             break;
 
-        case 2:
-            next.Draw(420 + 17, 48 + 65);
+        case Command::HardDrop: {
+            int tilesDropped = HardDrop();
+            UpdateScore(0, 0, tilesDropped, false, false);
             break;
+        }
 
-        default:
-            next.Draw(420 + 33, 48 + 49);
+        case Command::RotateClockwise:
+            RotateBlock(true);
             break;
-    }
 
-    switch(hold.id) {
-        case 0:
+        case Command::RotateCounterClockwise:
+            RotateBlock(false);
             break;
 
-        case 1:
-            OBlock().Draw(-123 + 50, 48 + 50);
+        case Command::Hold:
+            HoldBlock();
             break;
 
-        case 2:
-            IBlock().Draw(-91 + 17, 48 + 65);
+        case Command::Restart:
+            gameOver = false;
+            Reset();
+            break;
+    }
+}
+
+/**
+ * @brief Applies a key press.
+ * @details Moving left/right and soft dropping act once straight away, then repeat while held,
+ * see `Handling`. Any other command is applied once, as with `Execute()`.
+ * If both directions are held, the last one pressed wins.
+ * @param command The command bound to the pressed key.
+ */
+void Game::Press(Command command) {
+    ReplayEvent event;
+
+    switch(command) {
+        case Command::MoveLeft:
+            leftHeld = true;
+            shiftDirection = -1;
+            shiftTicks = 0;
+            event = ReplayEvent::LeftPressed;
             break;
 
-        case 3:
-            SBlock().Draw(-91 + 33, 48 + 49);
+        case Command::MoveRight:
+            rightHeld = true;
+            shiftDirection = 1;
+            shiftTicks = 0;
+            event = ReplayEvent::RightPressed;
             break;
 
-        case 4:
-            ZBlock().Draw(-91 + 33, 48 + 49);
+        case Command::SoftDrop:
+            softDropHeld = true;
+            softDropHeldTicks = 0;
+            event = ReplayEvent::SoftDropPressed;
             break;
 
-        case 5:
-            LBlock().Draw(-91 + 33, 48 + 49);
+        default:
+            Execute(command);
+            return;
+    }
+
+    if (recorder != nullptr) {
+        recorder -> Record(currentTick, (uint8_t)event);
+    }
+
+    if (gameOver) {
+        return;
+    }
+
+    if (command == Command::SoftDrop) {
+        if (!IsGravityStronger()) {
+            MoveDown(true);
+        }
+    } else if (command == Command::MoveLeft) {
+        MoveLeft();
+    } else {
+        MoveRight();
+    }
+}
+
+/**
+ * @brief Applies a key release, stopping the auto-repeat of a held input.
+ * @details Releasing a direction while the other is still held resumes the other direction,
+ * which has to charge its delay again.
+ * @param command The command bound to the released key.
+ */
+void Game::Release(Command command) {
+    ReplayEvent event;
+
+    switch(command) {
+        case Command::MoveLeft:
+            leftHeld = false;
+            event = ReplayEvent::LeftReleased;
             break;
 
-        case 6:
-            JBlock().Draw(-91 + 33, 48 + 49);
+        case Command::MoveRight:
+            rightHeld = false;
+            event = ReplayEvent::RightReleased;
             break;
 
-        case 7:
-            TBlock().Draw(-91 + 33, 48 + 49);
+        case Command::SoftDrop:
+            softDropHeld = false;
+            event = ReplayEvent::SoftDropReleased;
             break;
+
+        default:
+            return;
     }
 
-    GhostBlock();
+    if (recorder != nullptr) {
+        recorder -> Record(currentTick, (uint8_t)event);
+    }
+
+    if ((shiftDirection == -1 && !leftHeld) || (shiftDirection == 1 && !rightHeld)) {
+        shiftDirection = leftHeld ? -1 : (rightHeld ? 1 : 0);
+        shiftTicks = 0;
+    }
 }
 
 /**
- * @brief Binds non-movement keystrokes with game functionality.
- * @details Follows typical tetris keybinds on PC, with keystrokes to
- * rotate, hard drop and restart game.
+ * @brief Advances the simulation by a single tick.
+ * @details Repeats held inputs, then applies gravity and lock delay. Gravity pauses while soft dropping and
+ * resumes once soft drop is released, unless gravity is already faster than soft drop.
  */
-void Game::HandleSingleKeystrokes() {
-    int keyStroke = GetKeyPressed();
-    if (gameOver && keyStroke != 0) {
-        gameOver = false;
-        Reset();
-    } else {
-        switch(keyStroke) {
-            case KEY_SPACE: {
-                int tilesDropped = HardDrop();
-                UpdateScore(0, 0, tilesDropped, false, false);
-                break;
-            }
+void Game::Tick() {
+    PROFILE_SCOPE("Tick");
+    currentTick++;
+
+    if (gameOver) {
+        return;
+    }
 
-            case KEY_X:
-            case KEY_UP:
-                RotateBlockClockwise();
-                break;
-
-            case KEY_Z:
-            case KEY_LEFT_CONTROL:
-                RotateBlockCounterClockwise();
-                break;
-            
-            case KEY_C:
-            case KEY_LEFT_SHIFT:
-                HoldBlock();
-                break;
+    AutoRepeat();
+
+    if (!softDropHeld || IsGravityStronger()) {
+        if (currentTick - lastGravityTick >= (uint64_t)gravityTicks[Level() - 1]) {
+            lastGravityTick = currentTick;
+            MoveDown(false);
         }
     }
+
+    LockDelay();
 }
 
 /**
- * @brief Binds movement keystrokes with game functionality.
- * @details Follows typical tetris keybinds on PC for movement.
- * Press once to move one tile.
- * Hold to move across multiple tiles at a constant rate.
- * @param leftTime Pointer to `lastMoveLeftTime` in `main.cpp`.
- * @param rightTime Pointer to `lastMoveRightTime` in `main.cpp`.
- * @param downTime Pointer to `lastMoveDownTime` in `main.cpp`.
- * @param currentTime Pointer to `currentTime` in `main.cpp`.
+ * @brief Repeats the held inputs whose interval has elapsed this tick.
+ * @details With `Handling::arrTicks == 0` the tetromino moves as far as it can once the delay has passed,
+ * and with `Handling::softDropTicks == 0` it drops onto the stack.
  */
-void Game::HandleMovementKeystrokes(
-    double *leftTime, double *rightTime, double *downTime, double *currentTime, bool isGravityStronger
-) {
-    const double moveInterval = 0.1;
+void Game::AutoRepeat() {
+    if (shiftDirection != 0) {
+        if (shiftTicks >= handling.dasTicks) {
+            int repeatTicks = shiftTicks - handling.dasTicks;
+
+            if (handling.arrTicks == 0) {
+                while (!Collides(0, shiftDirection)) {
+                    (shiftDirection < 0) ? MoveLeft() : MoveRight();
+                }
+            } else if (repeatTicks % handling.arrTicks == 0) {
+                (shiftDirection < 0) ? MoveLeft() : MoveRight();
+            }
+        }
 
-    if (IsKeyPressed(KEY_LEFT)) {
-        MoveLeft();
-        *leftTime = *currentTime;
-    } else if (IsKeyDown(KEY_LEFT) && *currentTime - *leftTime >= moveInterval) {
-        MoveLeft();
-        *leftTime = *currentTime;
+        shiftTicks++;
     }
 
-    if (IsKeyPressed(KEY_RIGHT)) {
-        MoveRight();
-        *rightTime = *currentTime;
-    } else if (IsKeyDown(KEY_RIGHT) && *currentTime - *rightTime >= moveInterval) {
-        MoveRight();
-        *rightTime = *currentTime;
-    }
+    if (softDropHeld && !IsGravityStronger()) {
+        if (handling.softDropTicks == 0) {
+            while (!Collides(1, 0)) {
+                MoveDown(true);
+            }
+        } else if (softDropHeldTicks > 0 && softDropHeldTicks % handling.softDropTicks == 0) {
+            MoveDown(true);
+        }
 
-    if (IsKeyPressed(KEY_DOWN) && !isGravityStronger) {
-        MoveDown(true);
-        *downTime = *currentTime;
-    } else if ((IsKeyDown(KEY_DOWN) && *currentTime - *downTime >= moveInterval) && !isGravityStronger) {
-        MoveDown(true);
-        *downTime = *currentTime;
+        softDropHeldTicks++;
     }
 }
 
+/// @brief Current level of the player, capped at 15.
+/// @return Level based on the number of lines cleared.
+int Game::Level() const {
+    int calcLevel = 1 + linesCleared / 10;
+
+    return (calcLevel <= 15) ? calcLevel : 15;
+}
+
+/// @brief Checks if gravity pulls the tetromino down faster than a soft drop.
+/// @return `true` if gravity is at least as fast as soft drop, `false` otherwise.
+bool Game::IsGravityStronger() const {
+    return gravityTicks[Level() - 1] <= handling.softDropTicks;
+}
+
+/// @brief Number of ticks elapsed since the game was created.
+uint64_t Game::CurrentTick() const {
+    return currentTick;
+}
+
+/// @brief Seed the game was created with; replaying the same commands on the same seed reproduces the game.
+uint32_t Game::Seed() const {
+    return seed;
+}
+
+/**
+ * @brief Zobrist hash of the game state between placements, e.g. to key a transposition table.
+ * @details Covers the filled cells, the current and held tetromino, the position in the tetromino queue
+ * and whether the hold has been used. The playboard part is kept up to date by `Grid` as blocks lock
+ * and lines clear, so this only combines a few keys. The position of the current tetromino, the score
+ * and the clock are not included.
+ */
+uint64_t Game::Hash() const {
+    return grid.hash ^ zobristKeys.current[current.id] ^ zobristKeys.hold[hold.id] ^
+           ZobristQueue(queue.Dealt()) ^ (justHeld ? zobristKeys.justHeld : 0);
+}
+
+/// @brief Checks if the next Tetris or T-Spin clear would be a back-to-back.
+bool Game::IsB2BActive() const {
+    return b2bDifficult;
+}
+
+/**
+ * @brief Collects the events since the last call, then clears them.
+ * @details Each `gameEvent*` bit is set if the event happened at least once, e.g. to play its sound effect
+ * once per frame.
+ */
+uint8_t Game::TakeEvents() {
+    uint8_t taken = events;
+    events = 0;
+    return taken;
+}
+
+/// @brief Read-only access to the playboard.
+const Grid &Game::GetGrid() const {
+    return grid;
+}
+
+/// @brief Read-only access to the tetromino being controlled.
+const Block &Game::GetCurrentBlock() const {
+    return current;
+}
+
+/// @brief Queries an upcoming tetromino without copying any blocks.
+/// @param index `0` for the next tetromino, up to `NumPreviews() - 1`.
+/// @return Tetromino id, see `tetrominoes.h`.
+int Game::Preview(int index) const {
+    return queue.Peek(index);
+}
+
+/// @brief Number of upcoming tetrominoes that can be queried with `Preview()`.
+int Game::NumPreviews() const {
+    return queue.NumPreviews();
+}
+
+/// @brief Read-only access to the held tetromino; `id == 0` if nothing is held.
+const Block &Game::GetHeldBlock() const {
+    return hold;
+}
+
 /// @brief Method that houses the "move left" logic.
 /// @details If tetromino is under lock delay, decrement `lockResets` and reset delay time.
 void Game::MoveLeft() {
@@ -216,13 +377,15 @@ void Game::MoveLeft() {
         lastMoveRotate = false;
         current.Move(0, -1);
     
-        if (IsOutside(0, 0) || BlockCollision(0, 0)) {
+        if (Collides(0, 0)) {
             current.Move(0, 1);
             return;
         }
 
+        events |= gameEventMove;
+
         if (lockDelayActive) {
-            lockDelayStartTime = GetTime();
+            lockDelayStartTick = currentTick;
             lockResets -= 1;
         }
     }
@@ -235,13 +398,15 @@ void Game::MoveRight() {
         lastMoveRotate = false;
         current.Move(0, 1);
     
-        if (IsOutside(0, 0) || BlockCollision(0, 0)) {
+        if (Collides(0, 0)) {
             current.Move(0, -1);
             return;
         }
 
+        events |= gameEventMove;
+
         if (lockDelayActive) {
-            lockDelayStartTime = GetTime();
+            lockDelayStartTick = currentTick;
             lockResets -= 1;
         }
     }
@@ -250,14 +415,14 @@ void Game::MoveRight() {
 /// @brief Method that houses the "move down" or "soft drop" logic.
 void Game::MoveDown(bool softDrop) {
     if (!gameOver) {
-        if (IsOutside(1, 0) || BlockCollision(1, 0)) {
+        if (Collides(1, 0)) {
             // Block cannot move another tile down
             // If last move was a rotate, it should still be true
 
             // Start lock block timer
             if (!lockDelayActive) {
                 lockDelayActive = true;
-                lockDelayStartTime = GetTime();
+                lockDelayStartTick = currentTick;
             }
         } else {
             // Block can still be in free-fall
@@ -282,110 +447,41 @@ int Game::HardDrop() {
 
     if (!gameOver) {
         lastMoveRotate = false;
-        while (!IsOutside(0, 0) && !BlockCollision(0, 0)) {
-            current.Move(1, 0);
-            tilesDropped++;
-        }
-
-        current.Move(-1, 0);
+        tilesDropped = GhostRow();
+        current.Move(tilesDropped, 0);
         LockBlock();
     }
 
-    return tilesDropped - 1;
+    return tilesDropped;
 }
 
-/// @brief Method that houses the "clockwise rotation" logic.
+/// @brief Method that houses the rotation logic.
 /// @details Checks if tetromino passes any of the "Wall Kick" tests.
 /// If a test passes, the block will be placed in the appropriate position.
-/// If all tests fail, the block will not rotate
+/// If all tests fail, the block will not rotate.
 ///
 /// If tetromino is under lock delay, decrement `lockResets` and reset delay time.
-void Game::RotateBlockClockwise() {
+/// @param clockwise `true` to rotate clockwise, `false` to rotate counterclockwise.
+void Game::RotateBlock(bool clockwise) {
     if (!gameOver) {
-        // Wall kick cases for rotation
-        std::vector<Position> wallKickCases = current.RotateClockwise();
-    
-        bool rotated = false;
-        if (IsOutside(0, 0) || BlockCollision(0, 0)) {
-            for (int i = 0; i < 5; i++) {
-                if (!IsOutside(wallKickCases[i].row, wallKickCases[i].col) && 
-                    !BlockCollision(wallKickCases[i].row, wallKickCases[i].col)) {
-                    current.Move(wallKickCases[i].row, wallKickCases[i].col);
-                    rotated = true;
-                    lastMoveRotate = true;
-
-                    if (lockDelayActive) {
-                        lockDelayStartTime = GetTime();
-                        lockResets -= 1;
-                    }
-
-                    // play rotate sound
-                    break;
-                }
-            }
-
-            // Test failed: Undo rotation
-            if (!rotated) {
-                current.RotateCounterClockwise();
-                lastMoveRotate = false;
-            }
-        } else {
-            lastMoveRotate = true;
+        int previousState = current.rotationState;
+        int kick = current.Rotate(grid, clockwise);
 
-            if (lockDelayActive) {
-                lockDelayStartTime = GetTime();
-                lockResets -= 1;
-            }
-
-            // play rotate sound
+        if (kick < 0) {
+            lastMoveRotate = false;
+            return;
         }
-    }
-}
-
-/// @brief Method that houses the "counterclockwise rotation" logic.
-/// @details Checks if tetromino passes any of the "Wall Kick" tests.
-/// If a test passes, the block will be placed in the appropriate position.
-/// If all tests fail, the block will not rotate.
-///
-/// If tetromino is under lock delay, decrement `lockResets` and reset delay time.
-void Game::RotateBlockCounterClockwise() {
-    if (!gameOver) {
-        // Wall kick cases for rotation
-        std::vector<Position> wallKickCases = current.RotateCounterClockwise();
-    
-        bool rotated = false;
-        if (IsOutside(0, 0) || BlockCollision(0, 0)) {
-            for (int i = 0; i < 5; i++) {
-                if (!IsOutside(wallKickCases[i].row, wallKickCases[i].col) && 
-                    !BlockCollision(wallKickCases[i].row, wallKickCases[i].col)) {
-                    current.Move(wallKickCases[i].row, wallKickCases[i].col);
-                    rotated = true;
-                    lastMoveRotate = true;
-
-                    if (lockDelayActive) {
-                        lockDelayStartTime = GetTime();
-                        lockResets -= 1;
-                    }
-
-                    // play rotate sound
-                    break;
-                }
-            }
 
-            // Test failed: Undo rotation
-            if (!rotated) {
-                current.RotateCounterClockwise();
-                lastMoveRotate = false;
-            }
-        } else {
-            lastMoveRotate = true;
+        if (trace != nullptr) {
+            trace -> Record(currentTick, TraceEvent::Kick, current.id, previousState, current.rotationState, kick);
+        }
 
-            if (lockDelayActive) {
-                lockDelayStartTime = GetTime();
-                lockResets -= 1;
-            }
+        lastMoveRotate = true;
+        events |= gameEventRotate;
 
-            // play rotate sound
+        if (lockDelayActive) {
+            lockDelayStartTick = currentTick;
+            lockResets -= 1;
         }
     }
 }
@@ -394,41 +490,24 @@ void Game::RotateBlockCounterClockwise() {
  * @brief Determines whether the T-Spin is a mini T-Spin or a regular T-Spin.
  * @details This function is only called if `current.id` corresponds to a T-Block, i.e. `current.id == 7` and when `lastMoveRotate` is `true`.
  * All tetrominoes are created with an invisible grid in mind. Using this property, it is easy to find the center block
- * of the T-Block in the `TBlock` class under `tetrominoes.cpp`. See the `note` for more information.
+ * of the T-Block in `tetrominoCells` under `tetrominoes.h`. See the `note` for more information.
+ * The corners are counted by `Grid::FilledCorners()`, which is shared with the placement generator in `movegen.h`.
  * @return `true` if it is a regular T-Spin, `false` if it is a mini T-Spin.
  * @note The `centerBlock` is obtained through `tiles[3]` because it is index of the center block defined in all rotations of the T-Block.
  * 
- * See `class TBlock` in `tetrominoes.cpp`.
+ * See the T-Block in `tetrominoes.h`.
  */
 bool Game::TSpinType() {
-    std::vector<Position> tiles = current.GetCellPositions();
+    std::array<Position, 4> tiles = current.GetCellPositions();
     Position centerBlock = tiles[3];
-    std::vector<Position> cornerBlocks = {Position(-1, -1), Position(-1, 1), Position(1, 1), Position(1, -1)};
-    int noCornersFilled = 0;
-
-    printf("Center: (%d, %d)\n", centerBlock.row, centerBlock.col);
-    for (Position corner: cornerBlocks) {
-        int checkRow = centerBlock.row + corner.row;
-        int checkCol = centerBlock.col + corner.col;
-
-        printf("Checking corner (%d, %d) ", checkRow, checkCol);
-        if (!grid.IsOutsideBoundary(checkRow, checkCol) &&
-            grid.grid[checkRow][checkCol] != 0) {
-            printf("FILLED\n");
-            noCornersFilled += 1;
-        } else {
-            printf("EMPTY/OUTSIDE\n");
-        }
+    int noCornersFilled = grid.FilledCorners(centerBlock.row, centerBlock.col);
 
-        if (noCornersFilled >= 3) {
-            printf("Corners filled: %d\n", noCornersFilled);
-            printf("Regular T-Spin\n");
-            return true;
-        }
+    if (trace != nullptr) {
+        trace -> Record(currentTick, TraceEvent::TSpin, centerBlock.row, centerBlock.col, noCornersFilled >= 3,
+                        noCornersFilled);
     }
-    printf("Corners filled: %d\n", noCornersFilled);
-    printf("T-Spin mini\n");
-    return false;
+
+    return noCornersFilled >= 3;
 }
 
 /// @brief Method that prevents current block from being moved.
@@ -437,25 +516,29 @@ bool Game::TSpinType() {
 /// This method is also used to determine how many rows are cleared via `.ClearFullRows()`
 /// and updates the score accordingly.
 void Game::LockBlock() {
-    std::vector<Position> tiles = current.GetCellPositions();
+    PROFILE_SCOPE("LockBlock");
+    std::array<Position, 4> tiles = current.GetCellPositions();
     bool isTSpin = false;
     bool tSpinType = false;
     
     for (Position item: tiles) {
-        grid.grid[item.row][item.col] = current.id;
+        grid.SetCell(item.row, item.col, current.id);
     }
     
+    if (trace != nullptr) {
+        trace -> Record(currentTick, TraceEvent::Lock, current.id, current.rotationState, current.row, current.col);
+    }
+
     if (lastMoveRotate == true && current.id == 7) {
         tSpinType = TSpinType();
         isTSpin = true;
     }
 
-    current = next;
-    if (BlockCollision(0, 0)) {
+    current = NextBlock();
+    if (Collides(0, 0)) {
         gameOver = true;
     }
 
-    next = GetRandomBlock();
     int rowsCleared = grid.ClearFullRows();
     if (rowsCleared > 0) {
         comboCount++;
@@ -467,18 +550,52 @@ void Game::LockBlock() {
     lastMoveRotate = false;
     linesCleared += rowsCleared;
     justHeld = false;
+
+    events |= gameEventLock | ((rowsCleared > 0) ? gameEventLineClear : 0) |
+              ((tSpinRegular || tSpinMini) ? gameEventTSpin : 0);
+
+    if (trace != nullptr && rowsCleared > 0) {
+        SpinType spin = tSpinRegular ? SpinType::Regular : tSpinMini ? SpinType::Mini : SpinType::None;
+        trace -> Record(currentTick, TraceEvent::LineClear, rowsCleared, (int)spin, b2b, linesCleared);
+
+        if (comboCount > 0) {
+            trace -> Record(currentTick, TraceEvent::Combo, 0, 0, 0, comboCount);
+        }
+    }
+}
+
+/**
+ * @brief Locks the current tetromino at a placement found by `MoveGenerator`.
+ * @details Used by bots in place of the individual move commands. The lock is scored by `LockBlock()`
+ * as if the tetromino had been moved there and left to lock, so no drop points are awarded.
+ * @param placement Placement of the current tetromino, i.e. `placement.block.id == GetCurrentBlock().id`.
+ * @return `true` if the tetromino was locked, `false` if the game is over or the placement is for another tetromino.
+ */
+bool Game::Place(const Placement &placement) {
+    if (gameOver || placement.block.id != current.id) {
+        return false;
+    }
+
+    if (recorder != nullptr) {
+        recorder -> RecordPlace(currentTick, placement);
+    }
+
+    current = placement.block;
+    lastMoveRotate = placement.isTSpin;
+    lockDelayActive = false;
+    LockBlock();
+
+    return true;
 }
 
-/// @brief Method that is called in the game loop for lock delay.
+/// @brief Method that is called every tick for lock delay.
 /// @details Maximum time before a tetromino is locked is 0.5 seconds.
 /// Timer is reset if tetromino is in free fall again or moved/rotated.
 /// Maximum number of moves/rotations (when not in free fall) is 15.
 void Game::LockDelay() {
-    const double maxDelay = 0.5;
-    
     if (lockDelayActive) {
-        if (IsOutside(1, 0) || BlockCollision(1, 0)) {
-            if ((GetTime() - lockDelayStartTime) >= maxDelay || lockResets <= 0) {
+        if (Collides(1, 0)) {
+            if ((currentTick - lockDelayStartTick) >= (uint64_t)maxLockDelayTicks || lockResets <= 0) {
                 LockBlock();
                 lockDelayActive = false;
                 lockResets = 15;
@@ -490,84 +607,47 @@ void Game::LockDelay() {
 }
 
 /**
- * @brief Method to determine if the tetromino is moved outside the playable grid.
- * @param row Modifier to current tile row.
- * @param col Modifier to current tile column.
- * @return Returns `true` if the tetromino is outside the boundary and `false` otherwise.
- */
-bool Game::IsOutside(int row, int col) {
-    std::vector<Position> tiles = current.GetCellPositions();
-
-    for (Position item: tiles) {
-        if (grid.IsOutsideBoundary(item.row + row, item.col + col)) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-/**
- * @brief Checks if a block collides with another.
+ * @brief Checks if the tetromino would leave the playable grid or overlap another block.
  * @param row Modifier to current tile row.
  * @param col Modifier to current tile column.
  * @return Returns `true` if there is a collision and `false` otherwise.
  */
-bool Game::BlockCollision(int row, int col) {
-    std::vector<Position> tiles = current.GetCellPositions();
-
-    for (Position item: tiles) {
-        if (!grid.IsCellEmpty(item.row + row, item.col + col)) {
-            return true;
-        }
-    }
-
-    return false;
+bool Game::Collides(int row, int col) const {
+    return grid.Collides(current.row + row, current.col + col, current.GetShape());
 }
 
 /// @brief Resets the game state.
 /// @details Used to launch a new game when the game is over.
+/// The tetromino queue carries on, so consecutive games follow a single seeded sequence.
+/// Held keys are forgotten, so a new game always starts with no key held.
 void Game::Reset() {
     grid.Initialise();
-    blocks = GetAllBlocks();
-    current = GetRandomBlock();
-    next = GetRandomBlock();
+    current = NextBlock();
     score = 0;
     lastMoveRotate = false;
     linesCleared = 0;
     lockResets = 15;
     lockDelayActive = false;
-    lockDelayStartTime = 0.0;
+    lockDelayStartTick = currentTick;
+    lastGravityTick = currentTick;
     justHeld = false;
     comboCount = -1;
     b2bDifficult = false;
+    leftHeld = false;
+    rightHeld = false;
+    softDropHeld = false;
+    shiftDirection = 0;
+    shiftTicks = 0;
+    softDropHeldTicks = 0;
 }
 
 /// @brief Method that houses the ghost block logic
 /// @details Ghost blocks aid the player to determine the lowest possible position of a tetromino
-/// on the grid before it is locked.
-void Game::GhostBlock() {
-    std::vector<Position> tiles = current.GetCellPositions();
-    int ghostRow = 0;
-    bool canDrop = true;
-    
-    while (canDrop) {
-        for (Position item: tiles) {
-            int testRow = item.row + ghostRow + 1;
-            if (!grid.IsCellEmpty(testRow, item.col) ||
-            grid.IsOutsideBoundary(testRow, item.col)) {
-                canDrop = false;
-                break;
-            }
-        }
-        
-        if (canDrop) {
-            ghostRow++;
-        }
-    }
-    
-    // Draw ghost block
-    current.DrawGhost(ghostRow);
+/// on the grid before it is locked. Also used as the hard drop distance.
+/// @return Number of tiles the current tetromino can fall before landing.
+int Game::GhostRow() const {
+    PROFILE_SCOPE("GhostRow");
+    return grid.DropDistance(current.row, current.col, current.GetShape(), current.GetBottoms());
 }
 
 void Game::HoldBlock() {
@@ -577,49 +657,25 @@ void Game::HoldBlock() {
 
         if (hold.id == 0) {
             hold = current;
-            current = next;
-            next = GetRandomBlock();
+            current = NextBlock();
         } else {
             Block temp = hold;
             hold = current;
+            current = Block(temp.id);
+        }
 
-            switch (temp.id) {
-                case 1:
-                    current = OBlock();
-                    break;
-
-                case 2:
-                    current = IBlock();
-                    break;
-
-                case 3:
-                    current = SBlock();
-                    break;
-
-                case 4:
-                    current = ZBlock();
-                    break;
-
-                case 5:
-                    current = LBlock();
-                    break;
-
-                case 6:
-                    current = JBlock();
-                    break;
-
-                case 7:
-                    current = TBlock();
-                    break;
-            }
+        // Swapped in tetromino spawns inside the stack
+        if (Collides(0, 0)) {
+            gameOver = true;
         }
     }
 }
 
 /**
  * @brief Updates the score with reference to the common tetris scoring system.
- * @details Score updates are calculated and subsequently added to the public `score` variable.
- * Each relevant case has checks for T-Spins in order to award the appropriate scores.
+ * @details Score updates are looked up in `scoreTable`, built at compile time from the `SCORING_RULES`
+ * preset, and added to the public `score` variable. The entry also sets the T-Spin and back-to-back
+ * flags, so scoring a lock takes no branches and only integer arithmetic.
  * @param rowsCleared Number of rows cleared during a single `.LockBlock()` call.
  * @param softDropPoints Number of tiles moved to calculate the score for "Soft Drop".
  * @param hardDropPoints Number of tiles moved to calculate the score for "Hard Drop".
@@ -627,259 +683,202 @@ void Game::HoldBlock() {
  * @param isTSpin Whether the last move before locking is a T-Spin.
  */
 void Game::UpdateScore(int rowsCleared, int softDropPoints, int hardDropPoints, bool tSpinType, bool isTSpin) {
-    int calcLevel = 1 + floor(linesCleared / 10);
-    int level = (calcLevel <= 15) ? calcLevel : 15;
+    int64_t level = Level();
+    int spin = isTSpin ? (int)(tSpinType ? SpinType::Regular : SpinType::Mini) : (int)SpinType::None;
+    int chain = b2bDifficult ? 1 : 0;
+    const ScoreEntry &entry = scoreTable.clears[spin][rowsCleared];
 
     // Handling line clears
-    switch (rowsCleared) {
-        case 1: {
-            if (isTSpin) {
-                if (tSpinType) {
-                    tSpinRegular = true;
-                    tSpinMini = false;
-                    b2b = (b2bDifficult) ? true : false;
-                    score += (b2bDifficult) ? 800 * level * 1.5 : 800 * level;
-                    b2bDifficult = true;
-                } else {
-                    tSpinMini = true;
-                    tSpinRegular = false;
-                    b2b = (b2bDifficult) ? true : false;
-                    score += (b2bDifficult) ? 200 * level * 1.5 : 200 * level;
-                    b2bDifficult = true;
-                }
-            } else {
-                tSpinRegular = false;
-                tSpinMini = false;
-                b2b = false;
-                b2bDifficult = false;
-                score += 100 * level;
-            }
-            break;
-        }
+    score += entry.points[chain] * level;
+    b2b = entry.b2b[chain];
+    b2bDifficult = entry.chain[chain];
+    tSpinRegular = entry.tSpinRegular;
+    tSpinMini = entry.tSpinMini;
 
-        case 2: {
-            if (isTSpin) {
-                if (tSpinType) {
-                    tSpinRegular = true;
-                    tSpinMini = false;
-                    b2b = (b2bDifficult) ? true : false;
-                    score += (b2bDifficult) ? 1200 * level * 1.5 : 1200 * level;
-                    b2bDifficult = true;
-                } else {
-                    tSpinMini = true;
-                    tSpinRegular = false;
-                    b2b = (b2bDifficult) ? true : false;
-                    score += (b2bDifficult) ? 400 * level * 1.5 : 400 * level;
-                    b2bDifficult = true;
-                }
-            } else {
-                tSpinRegular = false;
-                tSpinMini = false;
-                b2b = false;
-                b2bDifficult = false;
-                score += 300 * level;
-            }
+    // Handling drops
+    score += softDropPoints * scoreTable.softDropPoints;
+    score += hardDropPoints * scoreTable.hardDropPoints;
+
+    // Handling combos
+    score += ((comboCount > 0) ? comboCount : 0) * scoreTable.comboPoints * level;
+}
+
+/**
+ * @brief Replaces the playboard with one of the preset game states.
+ * @details The current, held and upcoming tetrominoes, the score and the clock are kept.
+ * Used by tools that start from a known setup, e.g. `perft`.
+ * @param state The playboard to load.
+ */
+void Game::LoadGameState(GameState state) {
+    grid.Initialise();
+
+    switch(state) {
+        case GameState::Empty:
             break;
-        }
 
-        case 3: {
-            if (isTSpin) {
-                tSpinRegular = true;
-                tSpinMini = false;
-                b2b = (b2bDifficult) ? true : false;
-                score += (b2bDifficult) ? 1600 * level * 1.5 : 1600 * level;
-                b2bDifficult = true;
-            } else {
-                tSpinRegular = false;
-                tSpinMini = false;
-                b2b = false;
-                b2bDifficult = false;
-                score += 500 * level;
-            }
+        case GameState::TripleTSpin:
+            TripleTSpin();
             break;
-        }
 
-        case 4:
-            tSpinRegular = false;
-            tSpinMini = false;
-            b2b = (b2bDifficult) ? true : false;
-            score += (b2bDifficult) ? 800 * level * 1.5 : 800 * level;
-            b2bDifficult = true;
+        case GameState::DoubleTSpinRegular:
+            DoubleTSpinRegular();
             break;
 
-        default: {
-            if (isTSpin) {
-                if (tSpinType) {
-                    tSpinRegular = true;
-                    tSpinMini = false;
-                    score += 400 * level;
-                } else {
-                    tSpinMini = true;
-                    tSpinRegular = false;
-                    score += 100 * level;
-                }
-                b2b = false;
-            } else {
-                tSpinMini = false;
-                tSpinRegular = false;
-                b2b = false;
-            }
+        case GameState::DoubleTSpinMini:
+            DoubleTSpinMini();
             break;
-        }
-    }
 
-    // Handling drops
-    score += softDropPoints;
-    score += hardDropPoints * 2;
+        case GameState::SingleTSpinRegular:
+            SingleTSpinRegular();
+            break;
 
-    // Handling combos
-    if (comboCount >= 0) {
-        score += (comboCount * 50) * level;
+        case GameState::SingleTSpinMini:
+            SingleTSpinMini();
+            break;
     }
 }
 
-
 /// @brief Renders a Triple T-Spin setup on the playboard
 void Game::TripleTSpin() {
-    grid.grid[18][0] = 6;
-    grid.grid[19][0] = 6;
-    grid.grid[19][1] = 6;
-    grid.grid[19][2] = 6;
-
-    grid.grid[18][1] = 7;
-    grid.grid[17][1] = 7;
-    grid.grid[17][2] = 7;
-    grid.grid[17][0] = 7;
-
-    grid.grid[19][4] = 1;
-    grid.grid[19][5] = 1;
-    grid.grid[18][4] = 1;
-    grid.grid[18][5] = 1;
-
-    grid.grid[19][6] = 2;
-    grid.grid[19][7] = 2;
-    grid.grid[19][8] = 2;
-    grid.grid[19][9] = 2;
-
-    grid.grid[17][5] = 4;
-    grid.grid[17][6] = 4;
-    grid.grid[18][6] = 4;
-    grid.grid[18][7] = 4;
-
-    grid.grid[18][8] = 3;
-    grid.grid[17][8] = 3;
-    grid.grid[17][7] = 3;
-    grid.grid[16][7] = 3;
+    grid.SetCell(18, 0, 6);
+    grid.SetCell(19, 0, 6);
+    grid.SetCell(19, 1, 6);
+    grid.SetCell(19, 2, 6);
+
+    grid.SetCell(18, 1, 7);
+    grid.SetCell(17, 1, 7);
+    grid.SetCell(17, 2, 7);
+    grid.SetCell(17, 0, 7);
+
+    grid.SetCell(19, 4, 1);
+    grid.SetCell(19, 5, 1);
+    grid.SetCell(18, 4, 1);
+    grid.SetCell(18, 5, 1);
+
+    grid.SetCell(19, 6, 2);
+    grid.SetCell(19, 7, 2);
+    grid.SetCell(19, 8, 2);
+    grid.SetCell(19, 9, 2);
+
+    grid.SetCell(17, 5, 4);
+    grid.SetCell(17, 6, 4);
+    grid.SetCell(18, 6, 4);
+    grid.SetCell(18, 7, 4);
+
+    grid.SetCell(18, 8, 3);
+    grid.SetCell(17, 8, 3);
+    grid.SetCell(17, 7, 3);
+    grid.SetCell(16, 7, 3);
     
-    grid.grid[18][9] = 5;
-    grid.grid[17][9] = 5;
-    grid.grid[16][9] = 5;
-    grid.grid[16][8] = 5;
-
-    grid.grid[17][4] = 5;
-    grid.grid[16][4] = 5;
-    grid.grid[15][4] = 5;
-    grid.grid[15][3] = 5;
+    grid.SetCell(18, 9, 5);
+    grid.SetCell(17, 9, 5);
+    grid.SetCell(16, 9, 5);
+    grid.SetCell(16, 8, 5);
+
+    grid.SetCell(17, 4, 5);
+    grid.SetCell(16, 4, 5);
+    grid.SetCell(15, 4, 5);
+    grid.SetCell(15, 3, 5);
 }
 
 /// @brief Renders a regular Double T-Spin setup on the playboard
 void Game::DoubleTSpinRegular() {
-    grid.grid[18][0] = 6;
-    grid.grid[19][0] = 6;
-    grid.grid[19][1] = 6;
-    grid.grid[19][2] = 6;
-
-    grid.grid[18][1] = 4;
-    grid.grid[17][1] = 4;
-    grid.grid[17][2] = 4;
-    grid.grid[16][2] = 4;
-
-    grid.grid[19][4] = 2;
-    grid.grid[19][5] = 2;
-    grid.grid[19][6] = 2;
-    grid.grid[19][7] = 2;
-
-    grid.grid[18][5] = 5;
-    grid.grid[18][6] = 5;
-    grid.grid[18][7] = 5;
-    grid.grid[17][7] = 5;
-
-    grid.grid[18][8] = 1;
-    grid.grid[18][9] = 1;
-    grid.grid[19][8] = 1;
-    grid.grid[19][9] = 1;
+    grid.SetCell(18, 0, 6);
+    grid.SetCell(19, 0, 6);
+    grid.SetCell(19, 1, 6);
+    grid.SetCell(19, 2, 6);
+
+    grid.SetCell(18, 1, 4);
+    grid.SetCell(17, 1, 4);
+    grid.SetCell(17, 2, 4);
+    grid.SetCell(16, 2, 4);
+
+    grid.SetCell(19, 4, 2);
+    grid.SetCell(19, 5, 2);
+    grid.SetCell(19, 6, 2);
+    grid.SetCell(19, 7, 2);
+
+    grid.SetCell(18, 5, 5);
+    grid.SetCell(18, 6, 5);
+    grid.SetCell(18, 7, 5);
+    grid.SetCell(17, 7, 5);
+
+    grid.SetCell(18, 8, 1);
+    grid.SetCell(18, 9, 1);
+    grid.SetCell(19, 8, 1);
+    grid.SetCell(19, 9, 1);
 }
 
 /// @brief Renders a mini Double T-Spin setup on the playboard
 void Game::DoubleTSpinMini() {
-    grid.grid[18][0] = 6;
-    grid.grid[19][0] = 6;
-    grid.grid[19][1] = 6;
-    grid.grid[19][2] = 6;
-
-    grid.grid[18][1] = 2;
-    grid.grid[17][1] = 2;
-    grid.grid[16][1] = 2;
-    grid.grid[15][1] = 2;
-
-    grid.grid[19][4] = 2;
-    grid.grid[19][5] = 2;
-    grid.grid[19][6] = 2;
-    grid.grid[19][7] = 2;
-
-    grid.grid[18][5] = 5;
-    grid.grid[18][6] = 5;
-    grid.grid[18][7] = 5;
-    grid.grid[17][7] = 5;
-
-    grid.grid[18][8] = 1;
-    grid.grid[18][9] = 1;
-    grid.grid[19][8] = 1;
-    grid.grid[19][9] = 1;
+    grid.SetCell(18, 0, 6);
+    grid.SetCell(19, 0, 6);
+    grid.SetCell(19, 1, 6);
+    grid.SetCell(19, 2, 6);
+
+    grid.SetCell(18, 1, 2);
+    grid.SetCell(17, 1, 2);
+    grid.SetCell(16, 1, 2);
+    grid.SetCell(15, 1, 2);
+
+    grid.SetCell(19, 4, 2);
+    grid.SetCell(19, 5, 2);
+    grid.SetCell(19, 6, 2);
+    grid.SetCell(19, 7, 2);
+
+    grid.SetCell(18, 5, 5);
+    grid.SetCell(18, 6, 5);
+    grid.SetCell(18, 7, 5);
+    grid.SetCell(17, 7, 5);
+
+    grid.SetCell(18, 8, 1);
+    grid.SetCell(18, 9, 1);
+    grid.SetCell(19, 8, 1);
+    grid.SetCell(19, 9, 1);
 }
 
 /// @brief Renders a regular Single T-Spin setup on the playbord
 void Game::SingleTSpinRegular() {
-    grid.grid[17][2] = 4;
-    grid.grid[17][3] = 4;
-    grid.grid[18][3] = 4;
-    grid.grid[18][4] = 4;
-
-    grid.grid[17][5] = 1;
-    grid.grid[17][6] = 1;
-    grid.grid[18][5] = 1;
-    grid.grid[18][6] = 1;
-
-    grid.grid[17][7] = 6;
-    grid.grid[18][7] = 6;
-    grid.grid[18][8] = 6;
-    grid.grid[18][9] = 6;
-
-    grid.grid[19][0] = 2;
-    grid.grid[19][1] = 2;
-    grid.grid[19][2] = 2;
-    grid.grid[19][3] = 2;
-
-    grid.grid[19][6] = 2;
-    grid.grid[19][7] = 2;
-    grid.grid[19][8] = 2;
-    grid.grid[19][9] = 2;
+    grid.SetCell(17, 2, 4);
+    grid.SetCell(17, 3, 4);
+    grid.SetCell(18, 3, 4);
+    grid.SetCell(18, 4, 4);
+
+    grid.SetCell(17, 5, 1);
+    grid.SetCell(17, 6, 1);
+    grid.SetCell(18, 5, 1);
+    grid.SetCell(18, 6, 1);
+
+    grid.SetCell(17, 7, 6);
+    grid.SetCell(18, 7, 6);
+    grid.SetCell(18, 8, 6);
+    grid.SetCell(18, 9, 6);
+
+    grid.SetCell(19, 0, 2);
+    grid.SetCell(19, 1, 2);
+    grid.SetCell(19, 2, 2);
+    grid.SetCell(19, 3, 2);
+
+    grid.SetCell(19, 6, 2);
+    grid.SetCell(19, 7, 2);
+    grid.SetCell(19, 8, 2);
+    grid.SetCell(19, 9, 2);
 }
 
 /// @brief Renders a mini Single T-Spin setup on the playboard
 void Game::SingleTSpinMini() {
-    grid.grid[18][2] = 4;
-    grid.grid[18][3] = 4;
-    grid.grid[19][3] = 4;
-    grid.grid[19][4] = 4;
-
-    grid.grid[18][5] = 1;
-    grid.grid[18][6] = 1;
-    grid.grid[19][5] = 1;
-    grid.grid[19][6] = 1;
-
-    grid.grid[18][7] = 6;
-    grid.grid[19][7] = 6;
-    grid.grid[19][8] = 6;
-    grid.grid[19][9] = 6;
+    grid.SetCell(18, 2, 4);
+    grid.SetCell(18, 3, 4);
+    grid.SetCell(19, 3, 4);
+    grid.SetCell(19, 4, 4);
+
+    grid.SetCell(18, 5, 1);
+    grid.SetCell(18, 6, 1);
+    grid.SetCell(19, 5, 1);
+    grid.SetCell(19, 6, 1);
+
+    grid.SetCell(18, 7, 6);
+    grid.SetCell(19, 7, 6);
+    grid.SetCell(19, 8, 6);
+    grid.SetCell(19, 9, 6);
 }
\ No newline at end of file
@@ -1,59 +1,130 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include "grid.h"
-#include "tetrominoes.cpp"
+#include "block.h"
+#include "movegen.h"
+#include "piecequeue.h"
 
 
+class ReplayWriter;
+class EventTrace;
+
+// Simulation rate; every duration in the game rules is expressed in ticks
+const int ticksPerSecond = 60;
+
+// Player inputs understood by the simulation
+enum class Command {
+    MoveLeft,
+    MoveRight,
+    SoftDrop,
+    HardDrop,
+    RotateClockwise,
+    RotateCounterClockwise,
+    Hold,
+    Restart
+};
+
+// Auto-repeat of held inputs, in ticks
+// `dasTicks`: delay before a held move starts repeating; `arrTicks`: ticks between repeats, `0` moves to the wall at once
+// `softDropTicks`: ticks between soft drop steps while held, `0` drops to the stack at once
+struct Handling {
+    int dasTicks;
+    int arrTicks;
+    int softDropTicks;
+};
+
+// Previous fixed 0.1 second repeat
+const Handling defaultHandling = {6, 6, 6};
+
+// Longest handling setting, as replay headers store each one in a byte
+const int maxHandlingTicks = 255;
+
+// Events reported by `Game::TakeEvents()`, e.g. to play sound effects
+const uint8_t gameEventMove = 1 << 0;
+const uint8_t gameEventRotate = 1 << 1;
+const uint8_t gameEventLock = 1 << 2;
+const uint8_t gameEventLineClear = 1 << 3;
+const uint8_t gameEventTSpin = 1 << 4;
+
+// Preset playboards, see the "Game States" functions of `Game`
+enum class GameState {
+    Empty,
+    TripleTSpin,
+    DoubleTSpinRegular,
+    DoubleTSpinMini,
+    SingleTSpinRegular,
+    SingleTSpinMini
+};
+
 class Game {
     public:
         bool gameOver;
-        int score;
+        int64_t score;
         int linesCleared;
         int comboCount;
-        Music music;
+        Handling handling;
+        ReplayWriter *recorder;
+        EventTrace *trace;
         Game();
-        ~Game();
-        void Draw();
-        void HandleSingleKeystrokes();
-        void HandleMovementKeystrokes(
-            double *leftTime,
-            double *rightTime,
-            double *downTime,
-            double *currentTime,
-            bool isGravityStronger
-        );
-        void MoveDown(bool softDrop);
-        int HardDrop();
-        void LockDelay();
+        Game(uint32_t seed, int numPreviews = defaultPreviews);
+        void Execute(Command command);
+        void Press(Command command);
+        void Release(Command command);
+        void Tick();
+        bool Place(const Placement &placement);
+        void LoadGameState(GameState state);
+        int GhostRow() const;
+        uint64_t CurrentTick() const;
+        uint32_t Seed() const;
+        uint64_t Hash() const;
+        bool IsB2BActive() const;
+        uint8_t TakeEvents();
+        const Grid &GetGrid() const;
+        const Block &GetCurrentBlock() const;
+        int Preview(int index) const;
+        int NumPreviews() const;
+        const Block &GetHeldBlock() const;
 
         // Reporting
         bool tSpinRegular;
         bool tSpinMini;
         bool b2b;
-    
+
     private:
         Grid grid;
-        std::vector<Block> blocks;
+        uint32_t seed;
+        PieceQueue queue;
         Block current;
-        Block next;
         Block hold;
+        uint64_t currentTick;
+        uint64_t lastGravityTick;
+        bool leftHeld;
+        bool rightHeld;
+        bool softDropHeld;
+        int shiftDirection;
+        int shiftTicks;
+        int softDropHeldTicks;
         bool lastMoveRotate;
         int lockResets;
         bool lockDelayActive;
-        double lockDelayStartTime;
+        uint64_t lockDelayStartTick;
         bool justHeld;
         bool b2bDifficult;
-        Block GetRandomBlock();
-        std::vector<Block> GetAllBlocks();
+        uint8_t events;
+        Block NextBlock();
+        int Level() const;
+        bool IsGravityStronger() const;
         void MoveLeft();
         void MoveRight();
-        void RotateBlockClockwise();
-        void RotateBlockCounterClockwise();
+        void MoveDown(bool softDrop);
+        void AutoRepeat();
+        int HardDrop();
+        void RotateBlock(bool clockwise);
         bool TSpinType();
         void LockBlock();
-        bool IsOutside(int row, int col);
-        bool BlockCollision(int row, int col);
+        void LockDelay();
+        bool Collides(int row, int col) const;
         void Reset();
         void UpdateScore(
             int rowsCleared,
@@ -62,7 +133,6 @@ class Game {
             bool tSpinType,
             bool isTSpin
         );
-        void GhostBlock();
         void HoldBlock();
 
         // Game States
@@ -71,4 +141,4 @@ class Game {
         void DoubleTSpinMini();
         void SingleTSpinRegular();
         void SingleTSpinMini();
-};
\ No newline at end of file
+};
@@ -1,52 +1,50 @@
 #include <iostream>
+#include <cstring>
 #include "grid.h"
-#include "colours.h"
+#include "position.h"
+#include "profiler.h"
+#include "zobrist.h"
 
-/// @brief Defines grid traits and initialises empty grid and colours.
+/// @brief Defines grid traits and initialises empty grid.
 Grid::Grid() {
     numRows = 20;
     numCols = 10;
-    cellSize = 33;
+    revision = 0;
 
     Initialise();
-    colours = GetCellColours();
 }
 
-/// @brief Initialises grid array representation to empty, i.e. `0`.
+/// @brief Initialises grid to empty, i.e. walls only in `rows` and `0` in `colours` and `heights`.
+/// @details `revision` is incremented whenever the cells change so that renderers can cache the grid.
+/// `hash` is the Zobrist hash of the filled cells (see `zobrist.h`), kept up to date as cells are filled and cleared.
 void Grid::Initialise() {
-    for(int row = 0; row < numRows; row++) {
-        for(int col = 0; col < numCols; col++) {
-            grid[row][col] = 0;
-        }
+    revision++;
+    hash = 0;
+
+    for (int row = 0; row < numRows; row++) {
+        rows[row] = emptyRow;
     }
+
+    memset(colours, 0, sizeof(colours));
+    memset(heights, 0, sizeof(heights));
 }
 
 /// @brief Prints state of the grid array.
 void Grid::Print() {
     for (int row = 0; row < numRows; row++) {
         for (int col = 0; col < numCols; col++) {
-            std::cout << grid[row][col] << " ";
+            std::cout << (int)colours[row][col] << " ";
         }
 
         std::cout << std::endl;
     }
 }
 
-/// @brief Displays current state of the playboard in the game.
-void Grid::Draw() {
-    for (int row = 0; row < numRows; row++) {
-        for (int col = 0; col < numCols; col++) {
-            int cellValue = grid[row][col];
-            DrawRectangle(col * cellSize + 181, row * cellSize + 16, cellSize - 1, cellSize - 1, colours[cellValue]);
-        }
-    }
-}
-
 /// @brief Checks if the given coordinates are within the defined boundaries.
 /// @param row Coordinates for row.
 /// @param col Coordinates for column.
 /// @return `true` if coordinates are within the defined boundaries, `false` otherwise.
-bool Grid::IsOutsideBoundary(int row, int col) {
+bool Grid::IsOutsideBoundary(int row, int col) const {
     if (row >= 0 && row < numRows && col >= 0 && col < numCols) {
         return false;
     }
@@ -54,63 +52,115 @@ bool Grid::IsOutsideBoundary(int row, int col) {
     return true;
 }
 
-/// @brief Checks if the given coordinates contain an empty cell.
+/// @brief Counts the filled cells diagonally adjacent to a cell, as used to tell T-Spins apart.
+/// @details Corners outside the playboard count as empty.
 /// @param row Coordinates for row.
 /// @param col Coordinates for column.
-/// @return 'true' if coordinates contain an empty cell, i.e. `grid[row][col] == 0`, `false` otherwise.
-bool Grid::IsCellEmpty(int row, int col) {
-    if (grid[row][col] == 0) {
-        return true;
+/// @return Number of filled corners, from `0` to `4`.
+int Grid::FilledCorners(int row, int col) const {
+    const Position cornerBlocks[4] = {Position(-1, -1), Position(-1, 1), Position(1, 1), Position(1, -1)};
+    int noCornersFilled = 0;
+
+    for (Position corner: cornerBlocks) {
+        int checkRow = row + corner.row;
+        int checkCol = col + corner.col;
+
+        if (!IsOutsideBoundary(checkRow, checkCol) && !IsCellEmpty(checkRow, checkCol)) {
+            noCornersFilled += 1;
+        }
     }
 
-    return false;
+    return noCornersFilled;
+}
+
+/// @brief Fills a cell with a tetromino.
+/// @param row Coordinates for row.
+/// @param col Coordinates for column.
+/// @param id Tetromino id, used for the colour of the cell.
+void Grid::SetCell(int row, int col, int id) {
+    revision++;
+    if (IsCellEmpty(row, col)) {
+        hash ^= ZobristCell(row, col);
+    }
+
+    rows[row] |= (uint16_t)(1 << (col + wallBits));
+    colours[row][col] = (uint8_t)id;
+
+    if (numRows - row > heights[col]) {
+        heights[col] = (uint8_t)(numRows - row);
+    }
 }
 
 /// @brief Clears rows that are full.
 /// @details `completed` is used for score calculations.
+/// Incomplete rows are compacted downwards and the rows freed at the top are cleared.
+/// Every row may have moved, so `hash` is recomputed a row at a time.
 /// @return Number of rows that are cleared.
 int Grid::ClearFullRows() {
+    PROFILE_SCOPE("ClearFullRows");
     int completed = 0;
 
     for (int row = numRows - 1; row >= 0; row --) {
         if (IsRowFull(row)) {
-            ClearRow(row);
             completed += 1;
         } else if (completed > 0) {
             MoveRowsDown(row, completed);
         }
     }
 
+    for (int row = 0; row < completed; row ++) {
+        ClearRow(row);
+    }
+
+    if (completed > 0) {
+        UpdateHeights();
+        revision++;
+
+        hash = 0;
+        for (int row = completed; row < numRows; row++) {
+            hash ^= ZobristRow(row, rows[row]);
+        }
+    }
+
     return completed;
 }
 
 /// @brief Determines if the queried row is full.
 /// @param row Queried row.
 /// @return `true` if row is full and `false` otherwise.
-bool Grid::IsRowFull(int row) {
-    for (int col = 0; col < numCols; col ++) {
-        if (grid[row][col] == 0) {
-            return false;
-        }
-    }
-
-    return true;
+bool Grid::IsRowFull(int row) const {
+    return rows[row] == fullRow;
 }
 
-/// @brief Resets the target row, i.e. every cell is `0`.
+/// @brief Resets the target row, i.e. every cell is empty.
 /// @param row Target row.
 void Grid::ClearRow(int row) {
-    for (int col = 0; col < numCols; col ++) {
-        grid[row][col] = 0;
-    }
+    rows[row] = emptyRow;
+    memset(colours[row], 0, sizeof(colours[row]));
 }
 
 /// @brief Moves incomplete rows down.
 /// @param row Current row.
 /// @param numRows Number of rows to be moved down.
 void Grid::MoveRowsDown(int row, int numRows) {
-    for (int col = 0; col < numCols; col ++) {
-        grid[row + numRows][col] = grid[row][col];
-        grid[row][col] = 0;
+    rows[row + numRows] = rows[row];
+    memcpy(colours[row + numRows], colours[row], sizeof(colours[row]));
+}
+
+/// @brief Recomputes the height of every column from the occupancy rows.
+/// @details Height is the number of rows from the floor up to and including the highest filled cell.
+void Grid::UpdateHeights() {
+    uint16_t seen = 0;
+    memset(heights, 0, sizeof(heights));
+
+    for (int row = 0; row < numRows; row++) {
+        uint16_t found = (uint16_t)(rows[row] & ~emptyRow & ~seen);
+        seen |= found;
+
+        while (found != 0) {
+            int col = __builtin_ctz(found) - wallBits;
+            heights[col] = (uint8_t)(numRows - row);
+            found &= (uint16_t)(found - 1);
+        }
     }
-}
\ No newline at end of file
+}
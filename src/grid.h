@@ -1,27 +1,116 @@
 #pragma once
 
-#include <vector>
-#include <raylib.h>
+#include <cstdint>
 
 
+// Occupancy rows are padded with 3 solid wall columns on each side, i.e. bit `col + wallBits` is column `col`
+const int wallBits = 3;
+const uint16_t emptyRow = 0xE007;
+const uint16_t fullRow = 0xFFFF;
+
 class Grid {
     public:
-        int grid[20][10];
+        uint16_t rows[20];
+        uint8_t colours[20][10];
+        uint8_t heights[10];
+        uint32_t revision;
+        uint64_t hash;
 
         Grid();
         void Initialise();
         void Print();
-        void Draw();
-        bool IsOutsideBoundary(int row, int col);
-        bool IsCellEmpty(int row, int col);
+        bool IsOutsideBoundary(int row, int col) const;
+        bool IsCellEmpty(int row, int col) const;
+        int FilledCorners(int row, int col) const;
+        bool Collides(int row, int col, const uint16_t shape[4]) const;
+        int DropDistance(int row, int col, const uint16_t shape[4], const int8_t bottoms[4]) const;
+        void SetCell(int row, int col, int id);
         int ClearFullRows();
 
     private:
         int numRows;
         int numCols;
-        int cellSize;
-        std::vector<Color> colours;
-        bool IsRowFull(int row);
+        bool IsRowFull(int row) const;
         void ClearRow(int row);
         void MoveRowsDown(int row, int numRows);
-};
\ No newline at end of file
+        void UpdateHeights();
+};
+
+/// @brief Checks if the given coordinates contain an empty cell.
+/// @param row Coordinates for row.
+/// @param col Coordinates for column.
+/// @return `true` if coordinates contain an empty cell, `false` otherwise.
+inline bool Grid::IsCellEmpty(int row, int col) const {
+    return ((rows[row] >> (col + wallBits)) & 1) == 0;
+}
+
+/**
+ * @brief Checks if a tetromino shape overlaps the walls, the floor or occupied cells.
+ * @details Rows above the playboard count as outside, as in `IsOutsideBoundary()`.
+ * @param row Row of the top left corner of the shape's 4x4 bounding box.
+ * @param col Column of the top left corner of the shape's 4x4 bounding box.
+ * @param shape Occupancy mask of each bounding box row, where bit `n` is box column `n`.
+ * @return `true` if the shape does not fit at the given coordinates, `false` otherwise.
+ */
+inline bool Grid::Collides(int row, int col, const uint16_t shape[4]) const {
+    // Every box column lies beyond the walls
+    if (col < -wallBits || col > numCols + wallBits - 1) {
+        return true;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        if (shape[i] == 0) {
+            continue;
+        }
+
+        int checkRow = row + i;
+        if (checkRow < 0 || checkRow >= numRows) {
+            return true;
+        }
+
+        // Bits shifted past the top of the row are beyond the right wall
+        if (((uint32_t)shape[i] << (col + wallBits)) & (rows[checkRow] | 0xFFFF0000u)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Number of tiles a tetromino shape can fall before landing.
+ * @details Constant time using the column heights while the shape is above the surface of every column
+ * it occupies. A shape tucked under an overhang falls back to testing one row at a time.
+ * @param row Row of the top left corner of the shape's 4x4 bounding box.
+ * @param col Column of the top left corner of the shape's 4x4 bounding box.
+ * @param shape Occupancy mask of each bounding box row, where bit `n` is box column `n`.
+ * @param bottoms Lowest occupied bounding box row of each box column, `-1` if the column is empty.
+ * @return Number of rows the shape can move down without colliding.
+ */
+inline int Grid::DropDistance(int row, int col, const uint16_t shape[4], const int8_t bottoms[4]) const {
+    int distance = numRows;
+
+    for (int i = 0; i < 4; i++) {
+        if (bottoms[i] < 0) {
+            continue;
+        }
+
+        int surfaceRow = numRows - heights[col + i];
+        int landing = surfaceRow - (row + bottoms[i]) - 1;
+        if (landing < 0) {
+            // Under an overhang
+            distance = 0;
+            while (!Collides(row + distance + 1, col, shape)) {
+                distance++;
+            }
+
+            return distance;
+        }
+
+        if (landing < distance) {
+            distance = landing;
+        }
+    }
+
+    return distance;
+}
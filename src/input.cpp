@@ -0,0 +1,143 @@
+#include <cstdio>
+#include <cstring>
+#include <raylib.h>
+#include "input.h"
+
+
+// Names of the commands as written in a bindings file, indexed by `Command`
+const char *commandNames[8] = {
+    "MoveLeft", "MoveRight", "SoftDrop", "HardDrop", "RotateClockwise", "RotateCounterClockwise", "Hold", "Restart",
+};
+
+/// @brief Initialises an empty queue with the default bindings.
+InputQueue::InputQueue() {
+    head = 0;
+    count = 0;
+
+    BindDefaults();
+}
+
+/// @brief Binds a key to a command, replacing any previous binding of the key.
+/// @param key Raylib key code.
+/// @param command Command sent when the key is pressed or released.
+void InputQueue::Bind(int key, Command command) {
+    if (key > 0 && key < maxKeyCodes) {
+        bindings[key] = (int8_t)command;
+    }
+}
+
+/// @brief Removes the binding of a key.
+/// @param key Raylib key code.
+void InputQueue::Unbind(int key) {
+    if (key > 0 && key < maxKeyCodes) {
+        bindings[key] = -1;
+    }
+}
+
+/// @brief Replaces every binding with the typical tetris keybinds on PC.
+void InputQueue::BindDefaults() {
+    memset(bindings, -1, sizeof(bindings));
+
+    Bind(KEY_LEFT, Command::MoveLeft);
+    Bind(KEY_RIGHT, Command::MoveRight);
+    Bind(KEY_DOWN, Command::SoftDrop);
+    Bind(KEY_SPACE, Command::HardDrop);
+    Bind(KEY_X, Command::RotateClockwise);
+    Bind(KEY_UP, Command::RotateClockwise);
+    Bind(KEY_Z, Command::RotateCounterClockwise);
+    Bind(KEY_LEFT_CONTROL, Command::RotateCounterClockwise);
+    Bind(KEY_C, Command::Hold);
+    Bind(KEY_LEFT_SHIFT, Command::Hold);
+}
+
+/**
+ * @brief Adds bindings from a text file on top of the current ones.
+ * @details Each line holds a Raylib key code and a command name, e.g. `65 HardDrop` binds A to hard drop.
+ * `None` as the command name unbinds the key. Lines that cannot be parsed are skipped.
+ * @param path Path of the bindings file.
+ * @return `true` if the file was read, `false` if it could not be opened.
+ */
+bool InputQueue::LoadBindings(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        int key;
+        char name[64];
+
+        if (sscanf(line, "%d %63s", &key, name) != 2) {
+            continue;
+        }
+
+        if (strcmp(name, "None") == 0) {
+            Unbind(key);
+        }
+
+        for (int command = 0; command < 8; command++) {
+            if (strcmp(name, commandNames[command]) == 0) {
+                Bind(key, (Command)command);
+            }
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Queues every key event Raylib has observed since the last call.
+ * @details Presses are drained from Raylib's key queue in the order they happened, so several presses
+ * within one frame are all kept. A bound key that is already up again was tapped within the frame, and
+ * Raylib never reports its release, so the release is queued right after its press. Releases of the other
+ * bound keys follow. Raylib does not timestamp its events, so every event is stamped with the time of the poll.
+ * @param currentTime Current time in seconds.
+ */
+void InputQueue::Poll(double currentTime) {
+    int key;
+
+    while ((key = GetKeyPressed()) != 0) {
+        Push(currentTime, key, true);
+
+        if (key < maxKeyCodes && bindings[key] >= 0 && !IsKeyDown(key)) {
+            Push(currentTime, key, false);
+        }
+    }
+
+    for (key = 0; key < maxKeyCodes; key++) {
+        if (bindings[key] >= 0 && IsKeyReleased(key)) {
+            Push(currentTime, key, false);
+        }
+    }
+}
+
+/// @brief Takes the oldest pending event.
+/// @return `true` if an event was taken, `false` if the queue is empty.
+bool InputQueue::Pop(InputEvent &event) {
+    if (count == 0) {
+        return false;
+    }
+
+    event = events[head];
+    head = (head + 1) % inputQueueSize;
+    count--;
+
+    return true;
+}
+
+/// @brief Appends an event; events beyond the size of the queue are dropped.
+void InputQueue::Push(double time, int key, bool pressed) {
+    if (count == inputQueueSize) {
+        return;
+    }
+
+    InputEvent &event = events[(head + count) % inputQueueSize];
+    event.time = time;
+    event.key = key;
+    event.bound = key > 0 && key < maxKeyCodes && bindings[key] >= 0;
+    event.command = event.bound ? (Command)bindings[key] : Command::Restart;
+    event.pressed = pressed;
+    count++;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "game.h"
+
+
+// Raylib key codes are below 512; a ring buffer of events pending for the simulation
+const int maxKeyCodes = 512;
+const int inputQueueSize = 64;
+
+// A key press or release, stamped with the time it was observed in seconds
+// `bound` is `false` for keys without a binding, which only restart the game once it is over
+struct InputEvent {
+    double time;
+    int key;
+    Command command;
+    bool bound;
+    bool pressed;
+};
+
+class InputQueue {
+    public:
+        InputQueue();
+        void Bind(int key, Command command);
+        void Unbind(int key);
+        void BindDefaults();
+        bool LoadBindings(const char *path);
+        void Poll(double currentTime);
+        bool Pop(InputEvent &event);
+
+    private:
+        int8_t bindings[maxKeyCodes];
+        InputEvent events[inputQueueSize];
+        int head;
+        int count;
+        void Push(double time, int key, bool pressed);
+};
@@ -0,0 +1,127 @@
+#include <cstdio>
+#include <cstring>
+#include "latency.h"
+
+
+/// @brief Initialises an empty histogram with the overlay hidden.
+LatencyMonitor::LatencyMonitor() {
+    showOverlay = false;
+    count = 0;
+    numPending = 0;
+
+    memset(buckets, 0, sizeof(buckets));
+    memset(samples, 0, sizeof(samples));
+}
+
+/// @brief Notes a key event that has been applied to the game and awaits the next presented frame.
+/// @param inputTime Time the key event was observed in seconds, see `InputEvent::time`.
+void LatencyMonitor::MarkInput(double inputTime) {
+    if (numPending < maxPendingInputs) {
+        pendingInputs[numPending++] = inputTime;
+    }
+}
+
+/// @brief Records the latency of every pending key event once their frame has been presented.
+/// @param presentTime Time `EndDrawing()` returned in seconds.
+void LatencyMonitor::MarkPresented(double presentTime) {
+    for (int i = 0; i < numPending; i++) {
+        double latency = presentTime - pendingInputs[i];
+        int bucket = (int)(latency / latencyBucketSeconds);
+        bucket = (bucket < 0) ? 0 : (bucket >= latencyBuckets) ? latencyBuckets - 1 : bucket;
+
+        buckets[bucket]++;
+        samples[count % latencySamples] = {pendingInputs[i], latency};
+        count++;
+    }
+
+    numPending = 0;
+}
+
+/// @brief Latency below which the given fraction of the samples fall.
+/// @param fraction Fraction of the samples, e.g. `0.99` for the 99th percentile.
+/// @return Upper edge of the bucket holding the percentile in seconds, `0` if there are no samples.
+double LatencyMonitor::Percentile(double fraction) const {
+    uint64_t target = (uint64_t)(fraction * count);
+    uint64_t seen = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+
+    for (int bucket = 0; bucket < latencyBuckets; bucket++) {
+        seen += buckets[bucket];
+
+        if (seen > target) {
+            return (bucket + 1) * latencyBucketSeconds;
+        }
+    }
+
+    return latencyBuckets * latencyBucketSeconds;
+}
+
+/**
+ * @brief Writes the most recent samples and the percentiles to a CSV file.
+ * @details One row per sample with the time the key event was observed and its latency in milliseconds,
+ * oldest first, followed by the percentiles of every sample since the game started.
+ * @param path Path of the CSV file, overwritten if it exists.
+ * @return `true` if the file was written, `false` otherwise.
+ */
+bool LatencyMonitor::WriteCsv(const char *path) const {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint64_t first = (count > (uint64_t)latencySamples) ? count - latencySamples : 0;
+
+    fprintf(file, "input_time_s,latency_ms\n");
+    for (uint64_t i = first; i < count; i++) {
+        const LatencySample &sample = samples[i % latencySamples];
+        fprintf(file, "%.6f,%.3f\n", sample.inputTime, sample.latency * 1000);
+    }
+
+    fprintf(file, "\npercentile,latency_ms\n");
+    fprintf(file, "p50,%.2f\np95,%.2f\np99,%.2f\n", Percentile(0.50) * 1000, Percentile(0.95) * 1000, Percentile(0.99) * 1000);
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Draws the percentiles and the histogram over the top left of the window.
+ * @details Buckets are grouped into 1 ms bars up to 50 ms, scaled to the tallest bar.
+ */
+void LatencyMonitor::DrawOverlay(Font font) const {
+    if (!showOverlay) {
+        return;
+    }
+
+    const int numBars = 50;
+    const int bucketsPerBar = latencyBuckets / 250;
+    char text[96];
+
+    DrawRectangle(8, 8, 316, 170, {0, 0, 0, 200});
+    snprintf(text, sizeof(text), "Input latency (%llu)", (unsigned long long)count);
+    DrawTextEx(font, text, {16, 14}, 20, 2, WHITE);
+    snprintf(text, sizeof(text), "p50 %.1f  p95 %.1f  p99 %.1f ms",
+             Percentile(0.50) * 1000, Percentile(0.95) * 1000, Percentile(0.99) * 1000);
+    DrawTextEx(font, text, {16, 38}, 20, 2, WHITE);
+
+    uint32_t bars[numBars] = {};
+    uint32_t tallest = 1;
+    for (int bar = 0; bar < numBars; bar++) {
+        for (int i = 0; i < bucketsPerBar; i++) {
+            bars[bar] += buckets[bar * bucketsPerBar + i];
+        }
+
+        tallest = (bars[bar] > tallest) ? bars[bar] : tallest;
+    }
+
+    for (int bar = 0; bar < numBars; bar++) {
+        int height = (int)(90.0 * bars[bar] / tallest);
+        DrawRectangle(16 + bar * 6, 160 - height, 5, height, WHITE);
+    }
+
+    DrawTextEx(font, "0", {16, 162}, 12, 1, WHITE);
+    DrawTextEx(font, "50 ms", {280, 162}, 12, 1, WHITE);
+}
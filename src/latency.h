@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <raylib.h>
+
+
+// Histogram of 0.25 ms buckets up to 250 ms; slower samples are counted in the last bucket
+const int latencyBuckets = 1000;
+const double latencyBucketSeconds = 0.00025;
+
+// Most recent samples kept for the CSV dump, and key events awaiting the frame that shows them
+const int latencySamples = 4096;
+const int maxPendingInputs = 64;
+
+// One measured key event: when it was observed and how long until its frame was presented, in seconds
+struct LatencySample {
+    double inputTime;
+    double latency;
+};
+
+// Measures input-to-photon latency: from a key event being observed to `EndDrawing()` returning
+// for the first frame drawn after the event was applied
+class LatencyMonitor {
+    public:
+        bool showOverlay;
+        LatencyMonitor();
+        void MarkInput(double inputTime);
+        void MarkPresented(double presentTime);
+        double Percentile(double fraction) const;
+        bool WriteCsv(const char *path) const;
+        void DrawOverlay(Font font) const;
+
+    private:
+        uint32_t buckets[latencyBuckets];
+        uint64_t count;
+        LatencySample samples[latencySamples];
+        double pendingInputs[maxPendingInputs];
+        int numPending;
+};
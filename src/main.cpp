@@ -1,200 +1,223 @@
-#include <iostream>
-#include <math.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <raylib.h>
+#include "assets.h"
+#include "audio.h"
+#include "broadcast.h"
 #include "game.h"
-#include "colours.h"
-
-
-double gravity_lastUpdateTime = 0;
-double interval = 0.8;
-double lastMoveLeftTime = 0;
-double lastMoveRightTime = 0;
-double lastMoveDownTime = 0;
-int lastRecordedLinesCleared = 0;
-double reportStartTime = -1; // -1 means no active report
-bool hasActiveReport = false;
-int reportLinesCleared = 0;
-bool reportTSpinRegular = false;
-bool reportTSpinMini = false;
-bool reportB2B = false;
-bool lastTSpinRegular = false;
-bool lastTSpinMini = false;
+#include "input.h"
+#include "latency.h"
+#include "profiler.h"
+#include "renderer.h"
+#include "replay.h"
+#include "trace.h"
+
+
+// Longest stretch of simulation caught up in a single frame, so a stall does not trigger a burst of ticks
+const int maxCatchUpTicks = 15;
 
 /**
- * @brief Checks if the specified interval has passed since the last update.
- * @details This function compares the current time with the last update time and returns true if it has elapsed.
- * If the interval has passed, it updates the last update time to the current time.
- * @param interval The time interval in seconds to check against.
- * @return `true` if the interval has passed, `false` otherwise.
- * @note This is used to control the automatic falling of tetrominoes in the game.
+ * @brief Sends a key event to the game.
+ * @details Any key press restarts the game once it is over. Otherwise, presses of bound keys are sent
+ * as `Game::Press()`. Releases of bound keys are always sent as `Game::Release()`, even once the game is over.
+ * @param game Game to send the commands to.
+ * @param event Key event from the input queue.
  */
-bool EventTrigger(double interval, double *lastUpdateTime) {
-    double currentTime = GetTime();
-
-    if (currentTime - gravity_lastUpdateTime >= interval) {
-        *lastUpdateTime = currentTime;
-        return true;
+void ApplyInput(Game &game, const InputEvent &event) {
+    if (!event.pressed) {
+        if (event.bound) {
+            game.Release(event.command);
+        }
+        return;
     }
 
-    return false;
+    if (game.gameOver) {
+        game.Execute(Command::Restart);
+    } else if (event.bound) {
+        game.Press(event.command);
+    }
 }
 
-/// @brief Handles the gravity of the tetromino based on the level of the player.
-/// @param level Level of the player.
-/// @return Interval before tetromino falls one tile in seconds.
-double Gravity(int level) {
-    int x = level - 1;
-
-    return pow(0.8 - (x * 0.007), x);
+/// @brief Advances the game by one tick and publishes the new state to spectators.
+void TickGame(Game &game, SpectatorBroadcast &broadcast) {
+    game.Tick();
+    broadcast.Publish(game);
 }
 
-void Report(int numLinesCleared, bool tSpinRegular, bool tSpinMini, bool b2b, Font font) {
-    if (tSpinRegular) {
-        DrawTextEx(font, "T-Spin", {8 + 71, 590}, 24, 2, WHITE);
-    } else if (tSpinMini) {
-        DrawTextEx(font, "Mini", {8 + 116, 564}, 20, 2, WHITE);
-        DrawTextEx(font, "T-Spin", {8 + 71, 590}, 24, 2, WHITE);
-    }
-
-    if (numLinesCleared > 0) {
-        switch(numLinesCleared) {
-            case 1:
-                DrawTextEx(font, "SINGLE", {8 + 34, 620}, 30, 2, WHITE);
-                break;
-
-            case 2:
-                DrawTextEx(font, "DOUBLE", {8 + 20, 620}, 30, 2, WHITE);
-                break;
-
-            case 3:
-                DrawTextEx(font, "TRIPLE", {8 + 30, 620}, 30, 2, WHITE);
-                break;
-
-            case 4:
-                DrawTextEx(font, "TETRIS", {8 + 30, 620}, 30, 2, WHITE);
-                break;
-            
-            default:
-                break;
+/**
+ * @brief Reads the handling settings from the command line.
+ * @details `--das N`, `--arr N` and `--sdf N` set `Handling` in ticks, clamped to `0` to `maxHandlingTicks`;
+ * unknown arguments are ignored.
+ * @return The default handling with any given overrides.
+ */
+Handling ParseHandling(int argc, char **argv) {
+    Handling handling = defaultHandling;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        int value = atoi(argv[i + 1]);
+        value = (value < 0) ? 0 : value;
+        value = (value > maxHandlingTicks) ? maxHandlingTicks : value;
+
+        if (strcmp(argv[i], "--das") == 0) {
+            handling.dasTicks = value;
+        } else if (strcmp(argv[i], "--arr") == 0) {
+            handling.arrTicks = value;
+        } else if (strcmp(argv[i], "--sdf") == 0) {
+            handling.softDropTicks = value;
         }
     }
 
-    if (b2b) {
-        DrawTextEx(font, "b2b x1.5", {8 + 82, 652}, 14, 2, WHITE);
-    }
+    return handling;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    // Startup time, from here to the first frame being presented
+    std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
+    bool measureStartup = argc > 1 && strcmp(argv[argc - 1], "--measure-startup") == 0;
+
     // Initialising game window & attributes
-    InitWindow(692, 756, "Tetris");
+    InitWindow(screenWidth, screenHeight, "Tetris");
     SetTargetFPS(60);
 
-    Font font = LoadFontEx("fonts/Minecraft.ttf", 64, 0, 0);
+    // Baked into the executable, see `src/assets.h`
+    Font font = LoadEmbeddedFont();
+
+    // Music and sound effects play on their own thread, started once the first frame is shown
+    AudioPlayer audio;
+    bool firstFrame = true;
 
     // Creating game instance
     Game game = Game();
+    game.handling = ParseHandling(argc, argv);
+    Renderer renderer = Renderer(font);
+
+    // Key bindings, optionally remapped by `bindings.txt`, see `InputQueue::LoadBindings()`
+    InputQueue input;
+    input.LoadBindings("bindings.txt");
+
+    // Input-to-photon latency: F3 toggles the overlay, F4 writes `latency.csv`
+    LatencyMonitor latency;
+
+    // Recording every game of the session for bug reports, see `tools/replay.cpp`
+    ReplayWriter recorder;
+    if (recorder.Open("replay.trp", game, GameState::TripleTSpin)) {
+        game.recorder = &recorder;
+    }
+
+    // Locks, wall kicks, T-Spins, line clears and combos, written by a background thread, see `tools/trace.cpp`
+    EventTrace trace;
+    if (trace.Open("game.trace")) {
+        game.trace = &trace;
+    }
+
+    // Live state for stream overlays and commentary tools, see `tools/spectate.cpp`
+    SpectatorBroadcast broadcast;
+    broadcast.Open(spectatorName);
 
     // Game loop
+    // The simulation advances in fixed ticks of 1/60 seconds, however long each frame takes to render
+    const double tickDuration = 1.0 / ticksPerSecond;
+    double simulatedTime = GetTime();
+
     while (WindowShouldClose() == false) {
-        UpdateMusicStream(game.music);
-        game.HandleSingleKeystrokes();
+        profiler.BeginFrame();
 
-        // Tetromino movement
         double currentTime = GetTime();
-        bool isGravityStronger = interval < 0.1;
-        game.HandleMovementKeystrokes(&lastMoveLeftTime, &lastMoveRightTime, &lastMoveDownTime, &currentTime, isGravityStronger);
+        if (currentTime - simulatedTime > maxCatchUpTicks * tickDuration) {
+            simulatedTime = currentTime - maxCatchUpTicks * tickDuration;
+        }
+
+        // Key events in the order they happened, each applied after the ticks that precede it
+        {
+            PROFILE_SCOPE("Input");
+            InputEvent event;
+            input.Poll(currentTime);
 
-        // Gravity - Pauses when moving down; resumes once not moving down
-        bool downKeyUp = IsKeyUp(KEY_DOWN);
+            while (input.Pop(event)) {
+                while (event.time - simulatedTime >= tickDuration) {
+                    TickGame(game, broadcast);
+                    simulatedTime += tickDuration;
+                }
 
-        if (downKeyUp || isGravityStronger) {
-            int calcLevel = 1 + floor(game.linesCleared / 10);
-            int level = (calcLevel <= 15) ? calcLevel : 15;
-            double* ptrInterval = &interval;
-            *ptrInterval = Gravity(level);
+                ApplyInput(game, event);
 
-            if (EventTrigger(interval, &gravity_lastUpdateTime)) {
-                game.MoveDown(false);
+                if (event.pressed && event.bound) {
+                    latency.MarkInput(event.time);
+                }
             }
         }
 
-        // Lock delay
-        game.LockDelay();
+        if (IsKeyPressed(KEY_F3)) {
+            latency.showOverlay = !latency.showOverlay;
+        }
+
+        if (IsKeyPressed(KEY_F4)) {
+            latency.WriteCsv("latency.csv");
+        }
+
+        // Per-phase profiling: F5 toggles recording and the graph, F6 writes `trace.json` for chrome://tracing
+        if (IsKeyPressed(KEY_F5)) {
+            profiler.enabled = !profiler.enabled;
+        }
+
+        if (IsKeyPressed(KEY_F6)) {
+            profiler.WriteChromeTrace("trace.json");
+        }
+
+        // Gravity, auto-repeat and lock delay for every tick that has elapsed since the last frame
+        {
+            PROFILE_SCOPE("Simulation");
+
+            while (currentTime - simulatedTime >= tickDuration) {
+                TickGame(game, broadcast);
+                simulatedTime += tickDuration;
+            }
+        }
+
+        // Sound effects of everything that happened since the last frame
+        audio.PlayEvents(game.TakeEvents());
 
         // Drawing
         BeginDrawing();
-        ClearBackground(darkPurple);
-
-        // Score
-        DrawRectangle(0, 676, 692, 80, darkerPurple);
-        DrawRectangle(0, 676, 692, 8, lighterPurple);
-        char scoreText[10];
-        snprintf(scoreText, sizeof(scoreText), "%d", game.score);
-        Vector2 textSize = MeasureTextEx(font, scoreText, 35, 2);
-
-        DrawTextEx(font, scoreText, {181 + (330 - textSize.x) / 2, 692}, 35, 2, WHITE);
-
-        // Next block
-        DrawRectangleRounded({511, 8, 181, 213}, 0.3, 6, lighterPurple);
-        DrawRectangle(511, 8, 90, 8, lighterPurple);
-        DrawTextEx(font, "Next", {519 + 33, 16}, 30, 10, WHITE);
-        DrawRectangleRounded({519, 48, 165, 165}, 0.3, 6, darkerPurple);
-
-        // Hold block
-        DrawRectangleRounded({0, 8, 181, 213}, 0.3, 6, lighterPurple);
-        DrawRectangle(91, 8, 90, 8, lighterPurple);
-        DrawTextEx(font, "Hold", {8 + 37, 16}, 30, 10, WHITE);
-        DrawRectangleRounded({8, 48, 165, 165}, 0.3, 6, darkerPurple);
-
-        // Combo count
-        if (game.comboCount > 0) {
-            char comboText[10];
-            snprintf(comboText, sizeof(comboText), "%d COMBO", game.comboCount);
-            Vector2 comboSize = MeasureTextEx(font, comboText, 24, 2);
-            DrawTextEx(font, comboText, {8 + (165 - comboSize.x) / 2, 240}, 24, 2, WHITE);
-        }
 
-        // Reporting - Check for new events to report
-        int currentLinesCleared = game.linesCleared - lastRecordedLinesCleared;
-        bool newTSpinRegular = game.tSpinRegular && !lastTSpinRegular;
-        bool newTSpinMini = game.tSpinMini && !lastTSpinMini;
-        bool hasNewReport = (newTSpinMini || newTSpinRegular || currentLinesCleared > 0);
-        
-        // If we have a new report, start it immediately (replacing any existing one)
-        if (hasNewReport) {
-            hasActiveReport = true;
-            reportStartTime = currentTime;
-            reportLinesCleared = currentLinesCleared;
-            reportTSpinRegular = newTSpinRegular;
-            reportTSpinMini = newTSpinMini;
-            reportB2B = game.b2b;
-            lastRecordedLinesCleared = game.linesCleared;
+        {
+            PROFILE_SCOPE("Draw");
+            renderer.Draw(game, currentTime);
         }
-        
-        // Update T-spin state tracking
-        lastTSpinRegular = game.tSpinRegular;
-        lastTSpinMini = game.tSpinMini;
-        
-        // Display active report if within 3 second window
-        if (hasActiveReport && (currentTime - reportStartTime < 3.0)) {
-            Report(reportLinesCleared, reportTSpinRegular, reportTSpinMini, reportB2B, font);
-        } else if (hasActiveReport) {
-            // Report has expired, clear it
-            hasActiveReport = false;
+
+        {
+            PROFILE_SCOPE("Overlays");
+            latency.DrawOverlay(font);
+            renderer.DrawProfilerGraph();
         }
-        
-        game.Draw();
-        
-        // Game over
-        if (game.gameOver) {
-            DrawRectangle(0, 0, 692, 676, {0, 0, 0, 150});
-            DrawTextEx(font, "Game Over", {197, 274}, 50, 2, WHITE);
-            DrawTextEx(font, "Press any key", {267, 324}, 20, 2, WHITE);
-            DrawTextEx(font, "to restart", {267 + 25, 341}, 20, 2, WHITE);
+
+        {
+            PROFILE_SCOPE("EndDrawing");
+            EndDrawing();
         }
 
-        EndDrawing();
+        latency.MarkPresented(GetTime());
+
+        if (firstFrame) {
+            firstFrame = false;
+            std::chrono::duration<double, std::milli> startup = std::chrono::steady_clock::now() - launchTime;
+            TraceLog(LOG_INFO, "STARTUP: First frame presented after %.1f ms", startup.count());
+
+            if (measureStartup) {
+                break;
+            }
+
+            audio.Start();
+        }
     }
 
+    recorder.Close(game.CurrentTick(), game.score, game.linesCleared);
+    broadcast.Close();
+    trace.Close();
+
+    audio.Stop();
+    renderer.Unload();
+    UnloadFont(font);
     CloseWindow();
-}
\ No newline at end of file
+}
@@ -0,0 +1,189 @@
+#include <cstring>
+#include "movegen.h"
+
+
+// Rotation states of the I, S and Z-Blocks that cover the same tiles as an earlier rotation state, shifted
+// Maps each rotation state to the first equivalent state and the bounding box offset between the two
+struct CanonicalTable {
+    int8_t rotation[8][4];
+    int8_t row[8][4];
+    int8_t col[8][4];
+};
+
+constexpr CanonicalTable BuildCanonicalTable() {
+    CanonicalTable table = {};
+    int minRow[8][4] = {};
+    int minCol[8][4] = {};
+
+    for (int id = 1; id <= numTetrominoes; id++) {
+        for (int rotation = 0; rotation < tetrominoRotations[id]; rotation++) {
+            minRow[id][rotation] = 4;
+            minCol[id][rotation] = 4;
+
+            for (int tile = 0; tile < 4; tile++) {
+                const Position &item = tetrominoCells[id][rotation][tile];
+                minRow[id][rotation] = item.row < minRow[id][rotation] ? item.row : minRow[id][rotation];
+                minCol[id][rotation] = item.col < minCol[id][rotation] ? item.col : minCol[id][rotation];
+            }
+        }
+    }
+
+    for (int id = 1; id <= numTetrominoes; id++) {
+        for (int rotation = 0; rotation < tetrominoRotations[id]; rotation++) {
+            for (int earlier = 0; earlier <= rotation; earlier++) {
+                bool same = true;
+
+                for (int i = 0; i < 4; i++) {
+                    int rowA = minRow[id][rotation] + i;
+                    int rowB = minRow[id][earlier] + i;
+                    int maskA = rowA < 4 ? tetrominoShapes.masks[id][rotation][rowA] >> minCol[id][rotation] : 0;
+                    int maskB = rowB < 4 ? tetrominoShapes.masks[id][earlier][rowB] >> minCol[id][earlier] : 0;
+                    same = same && maskA == maskB;
+                }
+
+                if (same) {
+                    table.rotation[id][rotation] = (int8_t)earlier;
+                    table.row[id][rotation] = (int8_t)(minRow[id][rotation] - minRow[id][earlier]);
+                    table.col[id][rotation] = (int8_t)(minCol[id][rotation] - minCol[id][earlier]);
+                    break;
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+constexpr CanonicalTable canonicalRotations = BuildCanonicalTable();
+
+/// @brief Initialises an empty list of placements.
+MoveGenerator::MoveGenerator() {
+    numPlacements = 0;
+}
+
+/// @brief Packs the rotation state and bounding box coordinates of a tetromino into a state index.
+/// @param block Tetromino on the playboard; coordinates must lie within `moveGenRows` and `moveGenCols`.
+/// @return Index into the `visited`, `spun` and `emitted` bitsets.
+int MoveGenerator::StateIndex(const Block &block) const {
+    return (block.rotationState * moveGenRows + block.row + moveGenRowOffset) * moveGenCols + block.col + moveGenColOffset;
+}
+
+/// @brief Unpacks a state index into a tetromino on the playboard.
+/// @param index State index, see `StateIndex()`.
+/// @param id Tetromino id.
+/// @return Tetromino at the rotation state and bounding box coordinates of the state.
+Block MoveGenerator::StateBlock(int index, int id) const {
+    Block block = Block(id);
+    block.rotationState = (int8_t)(index / (moveGenRows * moveGenCols));
+    block.row = (int8_t)((index / moveGenCols) % moveGenRows - moveGenRowOffset);
+    block.col = (int8_t)(index % moveGenCols - moveGenColOffset);
+
+    return block;
+}
+
+/// @brief Queues a tetromino state if it has not been seen yet.
+/// @param block Tetromino state that does not collide with the grid.
+/// @param queueEnd End of the queue, incremented if the state is queued.
+/// @return `true` if the state was queued, `false` if it was already visited.
+bool MoveGenerator::Visit(const Block &block, int &queueEnd) {
+    int index = StateIndex(block);
+    uint64_t bit = (uint64_t)1 << (index & 63);
+
+    if (visited[index >> 6] & bit) {
+        return false;
+    }
+
+    visited[index >> 6] |= bit;
+    queue[queueEnd++] = (uint16_t)index;
+    return true;
+}
+
+/**
+ * @brief Enumerates every distinct final placement of a tetromino reachable from its current position.
+ * @details Breadth first search over the moves a player can make: left, right, soft drop and both rotations
+ * with the "wall kick" tests of `Block::Rotate()`, so tucks under overhangs and kicked spins are found.
+ * A state is final if the tetromino cannot move down any further. Rotation states that cover the same tiles
+ * (I, S and Z-Blocks) are reported once.
+ *
+ * A T-Block placement is tagged as a T-Spin if it can be entered by a rotation, in which case
+ * `Game::LockBlock()` would score it as one when the tetromino locks there.
+ * Gravity, lock delay and the limit on lock resets are not modelled.
+ * @param grid Playboard to place the tetromino on.
+ * @param start Tetromino at its current position, usually its spawn position.
+ * @return Number of placements written to `placements`; `0` if `start` collides with the grid.
+ */
+int MoveGenerator::Generate(const Grid &grid, const Block &start) {
+    int queueStart = 0;
+    int queueEnd = 0;
+    numPlacements = 0;
+
+    memset(visited, 0, sizeof(visited));
+    memset(spun, 0, sizeof(spun));
+    memset(emitted, 0, sizeof(emitted));
+
+    if (grid.Collides(start.row, start.col, start.GetShape())) {
+        return 0;
+    }
+
+    Visit(start, queueEnd);
+
+    while (queueStart < queueEnd) {
+        int index = queue[queueStart++];
+        Block block = StateBlock(index, start.id);
+        const uint16_t *shape = block.GetShape();
+
+        const Position moves[3] = {Position(0, -1), Position(0, 1), Position(1, 0)};
+        for (Position move: moves) {
+            if (!grid.Collides(block.row + move.row, block.col + move.col, shape)) {
+                Block moved = block;
+                moved.Move(move.row, move.col);
+                Visit(moved, queueEnd);
+            }
+        }
+
+        for (int clockwise = 0; clockwise < 2; clockwise++) {
+            Block rotated = block;
+
+            if (rotated.Rotate(grid, clockwise == 1) >= 0) {
+                Visit(rotated, queueEnd);
+
+                int rotatedIndex = StateIndex(rotated);
+                spun[rotatedIndex >> 6] |= (uint64_t)1 << (rotatedIndex & 63);
+            }
+        }
+    }
+
+    // Every visited state in the order it was found; keep those that rest on the stack or the floor
+    for (int i = 0; i < queueEnd; i++) {
+        int index = queue[i];
+        Block block = StateBlock(index, start.id);
+
+        if (!grid.Collides(block.row + 1, block.col, block.GetShape())) {
+            continue;
+        }
+
+        Block canonical = block;
+        canonical.rotationState = canonicalRotations.rotation[block.id][block.rotationState];
+        canonical.Move(canonicalRotations.row[block.id][block.rotationState],
+                       canonicalRotations.col[block.id][block.rotationState]);
+
+        int canonicalIndex = StateIndex(canonical);
+        uint64_t bit = (uint64_t)1 << (canonicalIndex & 63);
+        if (emitted[canonicalIndex >> 6] & bit) {
+            continue;
+        }
+        emitted[canonicalIndex >> 6] |= bit;
+
+        Placement &placement = placements[numPlacements++];
+        placement.block = block;
+        placement.isTSpin = block.id == 7 && (spun[index >> 6] & ((uint64_t)1 << (index & 63))) != 0;
+        placement.tSpinType = false;
+
+        if (placement.isTSpin) {
+            Position centerBlock = block.GetCellPositions()[3];
+            placement.tSpinType = grid.FilledCorners(centerBlock.row, centerBlock.col) >= 3;
+        }
+    }
+
+    return numPlacements;
+}
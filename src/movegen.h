@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include "grid.h"
+#include "block.h"
+
+
+// Range of bounding box coordinates a tetromino can take, i.e. rows -3 to 20 and columns -3 to 12
+const int moveGenRowOffset = 3;
+const int moveGenColOffset = wallBits;
+const int moveGenRows = 24;
+const int moveGenCols = 16;
+const int maxMoveGenStates = 4 * moveGenRows * moveGenCols;
+const int maxPlacements = maxMoveGenStates;
+
+// Final resting position of a tetromino, i.e. it cannot move down any further
+// `isTSpin` and `tSpinType` hold the values `Game::LockBlock()` would score the placement with
+struct Placement {
+    Block block;
+    bool isTSpin;
+    bool tSpinType;
+};
+
+class MoveGenerator {
+    public:
+        Placement placements[maxPlacements];
+        int numPlacements;
+        MoveGenerator();
+        int Generate(const Grid &grid, const Block &start);
+
+    private:
+        uint64_t visited[maxMoveGenStates / 64];
+        uint64_t spun[maxMoveGenStates / 64];
+        uint64_t emitted[maxMoveGenStates / 64];
+        uint16_t queue[maxMoveGenStates];
+        int StateIndex(const Block &block) const;
+        Block StateBlock(int index, int id) const;
+        bool Visit(const Block &block, int &queueEnd);
+};
@@ -0,0 +1,91 @@
+#include "piecequeue.h"
+#include "tetrominoes.h"
+
+
+/// @brief Initialises the randomizer with seed `0`.
+BagRandomizer::BagRandomizer() {
+    Seed(0);
+}
+
+/// @brief Restarts the randomizer; the same seed always deals the same sequence.
+/// @param seed Seed of the generator.
+void BagRandomizer::Seed(uint32_t seed) {
+    state = 0;
+    NextRandom();
+    state += seed;
+    NextRandom();
+
+    dealt = numTetrominoes;
+}
+
+/**
+ * @brief Deals the next tetromino.
+ * @details Once a bag is empty, all tetrominoes are refilled and shuffled (Fisher-Yates),
+ * so no tetromino is dealt twice within a bag.
+ * @return Tetromino id, see `tetrominoes.h`.
+ */
+int BagRandomizer::Next() {
+    if (dealt == numTetrominoes) {
+        for (int i = 0; i < numTetrominoes; i++) {
+            bag[i] = (uint8_t)(i + 1);
+        }
+
+        for (int i = numTetrominoes - 1; i > 0; i--) {
+            // Maps a 32-bit number onto [0, i] with a multiply instead of a modulo
+            int j = (int)(((uint64_t)NextRandom() * (uint64_t)(i + 1)) >> 32);
+            uint8_t temp = bag[i];
+            bag[i] = bag[j];
+            bag[j] = temp;
+        }
+
+        dealt = 0;
+    }
+
+    return bag[dealt++];
+}
+
+/// @brief Advances the PCG32 generator (XSH RR output function).
+/// @return A uniformly distributed 32-bit number.
+uint32_t BagRandomizer::NextRandom() {
+    uint64_t oldState = state;
+    state = oldState * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+    uint32_t rotation = (uint32_t)(oldState >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+/// @brief Initialises the queue with seed `0` and the default number of previews.
+PieceQueue::PieceQueue() {
+    Seed(0, defaultPreviews);
+}
+
+/**
+ * @brief Restarts the sequence and fills the queue.
+ * @details The sequence only depends on the seed, not on the number of previews.
+ * @param seed Seed of the randomizer.
+ * @param numPreviews Number of upcoming tetrominoes to keep, from `1` to `maxPreviews`.
+ */
+void PieceQueue::Seed(uint32_t seed, int numPreviews) {
+    numPreviews = (numPreviews < 1) ? 1 : (numPreviews > maxPreviews) ? maxPreviews : numPreviews;
+    randomizer.Seed(seed);
+    head = 0;
+    count = 0;
+    dealt = 0;
+
+    while (count < numPreviews) {
+        ids[count++] = (uint8_t)randomizer.Next();
+    }
+}
+
+/// @brief Deals the tetromino at the front of the queue and tops the queue up from the randomizer.
+/// @return Tetromino id, see `tetrominoes.h`.
+int PieceQueue::Pop() {
+    int id = ids[head];
+
+    ids[(head + count) & (pieceQueueSize - 1)] = (uint8_t)randomizer.Next();
+    head = (head + 1) & (pieceQueueSize - 1);
+    dealt++;
+
+    return id;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Upcoming tetrominoes kept in the queue; `maxPreviews` is one less than the ring buffer size
+const int pieceQueueSize = 16;
+const int maxPreviews = pieceQueueSize - 1;
+const int defaultPreviews = 5;
+
+// 7-bag randomizer: deals every tetromino once, in a shuffled order, before starting a new bag
+// Backed by a PCG32 generator, so a seed always deals the same sequence on every platform
+class BagRandomizer {
+    public:
+        BagRandomizer();
+        void Seed(uint32_t seed);
+        int Next();
+
+    private:
+        uint64_t state;
+        uint8_t bag[7];
+        int dealt;
+        uint32_t NextRandom();
+};
+
+// Tetromino ids still to be dealt, in order, stored in a ring buffer
+class PieceQueue {
+    public:
+        PieceQueue();
+        void Seed(uint32_t seed, int numPreviews);
+        int Pop();
+        int Peek(int index) const;
+        int NumPreviews() const;
+        uint64_t Dealt() const;
+
+    private:
+        BagRandomizer randomizer;
+        uint8_t ids[pieceQueueSize];
+        int head;
+        int count;
+        uint64_t dealt;
+};
+
+/// @brief Queries an upcoming tetromino without dealing it.
+/// @param index `0` for the next tetromino, up to `NumPreviews() - 1`.
+/// @return Tetromino id, see `tetrominoes.h`.
+inline int PieceQueue::Peek(int index) const {
+    return ids[(head + index) & (pieceQueueSize - 1)];
+}
+
+/// @brief Number of upcoming tetrominoes that can be queried with `Peek()`.
+inline int PieceQueue::NumPreviews() const {
+    return count;
+}
+
+/// @brief Number of tetrominoes dealt with `Pop()` since the queue was seeded.
+inline uint64_t PieceQueue::Dealt() const {
+    return dealt;
+}
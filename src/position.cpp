@@ -1,10 +0,0 @@
-#include "position.h"
-
-
-/// @brief Sets the current position.
-/// @param row Coordinates for row.
-/// @param col Coordinates for column.
-Position::Position(int row, int col) {
-    this -> row = row;
-    this -> col = col;
-}
\ No newline at end of file
@@ -4,5 +4,10 @@
 class Position {
     public:
         int row, col;
-        Position(int row, int col);
-};
\ No newline at end of file
+
+        /// @brief Sets the current position.
+        /// @param row Coordinates for row.
+        /// @param col Coordinates for column.
+        constexpr Position(int row, int col) : row(row), col(col) {}
+        constexpr Position() : row(0), col(0) {}
+};
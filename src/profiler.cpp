@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "profiler.h"
+
+
+Profiler profiler;
+
+/// @brief Initialises a disabled profiler with empty buffers.
+Profiler::Profiler() {
+    enabled = false;
+    depth = 0;
+    origin = 0;
+    origin = Now();
+    count = 0;
+    numPhases = 0;
+    frame = 0;
+
+    memset(frameTotals, 0, sizeof(frameTotals));
+}
+
+/// @brief Monotonic time in nanoseconds since the profiler was created.
+int64_t Profiler::Now() const {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - origin;
+}
+
+/// @brief Starts a new frame of per-phase totals for the graph.
+void Profiler::BeginFrame() {
+    frame++;
+    memset(frameTotals[frame % profileFrames], 0, sizeof(frameTotals[0]));
+}
+
+/**
+ * @brief Adds a timed scope to the ring buffer, overwriting the oldest once full.
+ * @details Outermost scopes (`depth == 0`) are also added to the totals of the current frame,
+ * with one phase per distinct name.
+ * @param name Name of the scope.
+ * @param start Start time in nanoseconds, see `Now()`.
+ * @param end End time in nanoseconds.
+ * @param depth Number of enclosing scopes.
+ */
+void Profiler::Record(const char *name, int64_t start, int64_t end, int depth) {
+    ProfileEvent &event = events[count % profileCapacity];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    event.depth = depth;
+    count++;
+
+    if (depth != 0) {
+        return;
+    }
+
+    int phase = 0;
+    while (phase < numPhases && phaseNames[phase] != name) {
+        phase++;
+    }
+
+    if (phase == numPhases) {
+        if (numPhases == maxProfilePhases) {
+            return;
+        }
+
+        phaseNames[numPhases++] = name;
+    }
+
+    frameTotals[frame % profileFrames][phase] += (end - start) / 1000000.0f;
+}
+
+/**
+ * @brief Writes the ring buffer in the Chrome trace event format.
+ * @details Open the file in `chrome://tracing` or Perfetto. Events are complete ("X") events
+ * in microseconds, oldest first.
+ * @param path Path of the JSON file, overwritten if it exists.
+ * @return `true` if the file was written, `false` otherwise.
+ */
+bool Profiler::WriteChromeTrace(const char *path) const {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint64_t first = (count > (uint64_t)profileCapacity) ? count - profileCapacity : 0;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (uint64_t i = first; i < count; i++) {
+        const ProfileEvent &event = events[i % profileCapacity];
+
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+                event.name, event.start / 1000.0, event.duration / 1000.0, (i + 1 < count) ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(file);
+    return true;
+}
+
+/// @brief Number of distinct outermost scopes seen so far.
+int Profiler::NumPhases() const {
+    return numPhases;
+}
+
+/// @brief Name of an outermost scope.
+/// @param phase Index from `0` to `NumPhases() - 1`, in the order the scopes were first seen.
+const char *Profiler::PhaseName(int phase) const {
+    return phaseNames[phase];
+}
+
+/// @brief Total time spent in an outermost scope during a recent frame.
+/// @param framesAgo `1` for the last complete frame, up to `profileFrames - 1`.
+/// @param phase Index from `0` to `NumPhases() - 1`.
+/// @return Time in milliseconds.
+float Profiler::PhaseMilliseconds(int framesAgo, int phase) const {
+    if ((uint64_t)framesAgo > frame) {
+        return 0;
+    }
+
+    return frameTotals[(frame - framesAgo) % profileFrames][phase];
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Ring buffer of the most recent timed scopes, and per-frame totals of the outermost scopes for the graph
+const int profileCapacity = 1 << 16;
+const int profileFrames = 240;
+const int maxProfilePhases = 12;
+
+// A timed scope; times are in nanoseconds since the profiler was created
+struct ProfileEvent {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    int32_t depth;
+};
+
+// Records `ScopedTimer`s while `enabled`; when disabled a timer only costs a branch
+// Not thread safe: once enabled, every thread's scopes write to the same ring and depth. Only enable it in a
+// process where a single thread runs `PROFILE_SCOPE`s, e.g. the game's window loop. `VectorEnv::Step()` and
+// `ComputeStackFeatures()` are timed too, so keep it disabled under tournament workers or C API callers that
+// step environments from several threads
+class Profiler {
+    public:
+        bool enabled;
+        int depth;
+        Profiler();
+        int64_t Now() const;
+        void BeginFrame();
+        void Record(const char *name, int64_t start, int64_t end, int depth);
+        bool WriteChromeTrace(const char *path) const;
+        int NumPhases() const;
+        const char *PhaseName(int phase) const;
+        float PhaseMilliseconds(int framesAgo, int phase) const;
+
+    private:
+        int64_t origin;
+        ProfileEvent events[profileCapacity];
+        uint64_t count;
+        const char *phaseNames[maxProfilePhases];
+        int numPhases;
+        float frameTotals[profileFrames][maxProfilePhases];
+        uint64_t frame;
+};
+
+extern Profiler profiler;
+
+// Times the enclosing scope, see `PROFILE_SCOPE`
+class ScopedTimer {
+    public:
+        ScopedTimer(const char *name);
+        ~ScopedTimer();
+
+    private:
+        const char *name;
+        int64_t start;
+};
+
+/// @brief Starts timing a scope if the profiler is enabled.
+/// @param name Name of the scope; must be a string literal, as only the pointer is kept.
+inline ScopedTimer::ScopedTimer(const char *name) {
+    this -> name = name;
+    start = -1;
+
+    if (profiler.enabled) {
+        start = profiler.Now();
+        profiler.depth++;
+    }
+}
+
+/// @brief Records the scope if it was started while the profiler was enabled.
+inline ScopedTimer::~ScopedTimer() {
+    if (start >= 0) {
+        profiler.depth--;
+        profiler.Record(name, start, profiler.Now(), profiler.depth);
+    }
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing block under `name`
+#define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(scopedTimer, __LINE__)(name)
@@ -0,0 +1,390 @@
+#include <cstdio>
+#include <cstring>
+#include "renderer.h"
+#include "colours.h"
+
+
+/// @brief Initialises drawing attributes, the cached interface and playboard, and reporting state.
+/// @param font Font used for all interface text; owned by the caller.
+/// @note Must be called after `InitWindow()`.
+Renderer::Renderer(Font font) {
+    this -> font = font;
+    cellSize = 33;
+
+    // Static interface is drawn once; labels are measured on first use
+    chromeTexture = LoadRenderTexture(screenWidth, screenHeight);
+    BakeChrome();
+    scoreLabel.value = -1;
+    comboLabel.value = -1;
+
+    // Cached playboard starts out empty; every row is drawn on first use
+    gridTexture = LoadRenderTexture(10 * cellSize, 20 * cellSize);
+    BeginTextureMode(gridTexture);
+    ClearBackground(darkPurple);
+    EndTextureMode();
+    memset(drawnColours, 0xFF, sizeof(drawnColours));
+    drawnRevision = 0;
+
+    lastRecordedLinesCleared = 0;
+    reportStartTime = -1; // -1 means no active report
+    hasActiveReport = false;
+    reportLinesCleared = 0;
+    reportTSpinRegular = false;
+    reportTSpinMini = false;
+    reportB2B = false;
+    lastTSpinRegular = false;
+    lastTSpinMini = false;
+}
+
+/// @brief Frees GPU resources held by the renderer.
+/// @note Must be called before `CloseWindow()`.
+void Renderer::Unload() {
+    UnloadRenderTexture(chromeTexture);
+    UnloadRenderTexture(gridTexture);
+}
+
+/**
+ * @brief Draws a complete frame of the game.
+ * @details Must be called between `BeginDrawing()` and `EndDrawing()`.
+ * @param game Game state to draw.
+ * @param currentTime Current time in seconds, used to time out line clear reports.
+ */
+void Renderer::Draw(const Game &game, double currentTime) {
+    ClearBackground(darkPurple);
+
+    DrawInterface(game);
+    DrawReport(game, currentTime);
+    DrawBoard(game);
+
+    if (game.gameOver) {
+        DrawGameOver();
+    }
+}
+
+/**
+ * @brief Draws the parts of the interface that never change into `chromeTexture`.
+ * @details Inclusive of the background, the score bar, the "Next" and "Hold" panels with their labels
+ * and the border around the playboard.
+ */
+void Renderer::BakeChrome() {
+    BeginTextureMode(chromeTexture);
+    ClearBackground(darkPurple);
+
+    // Score
+    DrawRectangle(0, 676, 692, 80, darkerPurple);
+    DrawRectangle(0, 676, 692, 8, lighterPurple);
+
+    // Next block
+    DrawRectangleRounded({511, 8, 181, 213}, 0.3, 6, lighterPurple);
+    DrawRectangle(511, 8, 90, 8, lighterPurple);
+    DrawTextEx(font, "Next", {519 + 33, 16}, 30, 10, WHITE);
+    DrawRectangleRounded({519, 48, 165, 165}, 0.3, 6, darkerPurple);
+
+    // Further upcoming blocks
+    DrawRectangleRounded({511, 229, 181, 439}, 0.15, 6, lighterPurple);
+    DrawRectangleRounded({519, 237, 165, 423}, 0.15, 6, darkerPurple);
+
+    // Hold block
+    DrawRectangleRounded({0, 8, 181, 213}, 0.3, 6, lighterPurple);
+    DrawRectangle(91, 8, 90, 8, lighterPurple);
+    DrawTextEx(font, "Hold", {8 + 37, 16}, 30, 10, WHITE);
+    DrawRectangleRounded({8, 48, 165, 165}, 0.3, 6, darkerPurple);
+
+    // Playboard border
+    DrawRectangle(173, 8, 346, 676, lighterPurple);
+
+    EndTextureMode();
+}
+
+/**
+ * @brief Formats and measures a label, skipping both if its value is unchanged.
+ * @param label Label to update.
+ * @param value Value to display.
+ * @param format `printf` style format with a single `%lld`.
+ * @param fontSize Font size used to measure the text.
+ */
+void Renderer::UpdateLabel(CachedLabel &label, int64_t value, const char *format, float fontSize) {
+    if (label.value == value) {
+        return;
+    }
+
+    label.value = value;
+    snprintf(label.text, sizeof(label.text), format, (long long)value);
+    label.size = MeasureTextEx(font, label.text, fontSize, 2);
+}
+
+/// @brief Draws the pre-rendered interface, the score and the combo count.
+/// @note Render textures are stored upside down, hence the negative source height.
+void Renderer::DrawInterface(const Game &game) {
+    PROFILE_SCOPE("DrawInterface");
+    DrawTextureRec(chromeTexture.texture, {0, 0, (float)screenWidth, -(float)screenHeight}, {0, 0}, WHITE);
+
+    // Score
+    UpdateLabel(scoreLabel, game.score, "%lld", 35);
+    DrawTextEx(font, scoreLabel.text, {181 + (330 - scoreLabel.size.x) / 2, 692}, 35, 2, WHITE);
+
+    // Combo count
+    if (game.comboCount > 0) {
+        UpdateLabel(comboLabel, game.comboCount, "%lld COMBO", 24);
+        DrawTextEx(font, comboLabel.text, {8 + (165 - comboLabel.size.x) / 2, 240}, 24, 2, WHITE);
+    }
+}
+
+/**
+ * @brief Reports line clears, T-Spins and back-to-backs below the "Hold" panel.
+ * @details A new event replaces any existing report immediately. Reports are displayed for 3 seconds.
+ * @param game Game state to check for new events.
+ * @param currentTime Current time in seconds.
+ */
+void Renderer::DrawReport(const Game &game, double currentTime) {
+    // Check for new events to report
+    int currentLinesCleared = game.linesCleared - lastRecordedLinesCleared;
+    bool newTSpinRegular = game.tSpinRegular && !lastTSpinRegular;
+    bool newTSpinMini = game.tSpinMini && !lastTSpinMini;
+    bool hasNewReport = (newTSpinMini || newTSpinRegular || currentLinesCleared > 0);
+
+    if (hasNewReport) {
+        hasActiveReport = true;
+        reportStartTime = currentTime;
+        reportLinesCleared = currentLinesCleared;
+        reportTSpinRegular = newTSpinRegular;
+        reportTSpinMini = newTSpinMini;
+        reportB2B = game.b2b;
+        lastRecordedLinesCleared = game.linesCleared;
+    }
+
+    // Update T-spin state tracking
+    lastTSpinRegular = game.tSpinRegular;
+    lastTSpinMini = game.tSpinMini;
+
+    if (!hasActiveReport) {
+        return;
+    }
+
+    if (currentTime - reportStartTime >= 3.0) {
+        // Report has expired, clear it
+        hasActiveReport = false;
+        return;
+    }
+
+    if (reportTSpinRegular) {
+        DrawTextEx(font, "T-Spin", {8 + 71, 590}, 24, 2, WHITE);
+    } else if (reportTSpinMini) {
+        DrawTextEx(font, "Mini", {8 + 116, 564}, 20, 2, WHITE);
+        DrawTextEx(font, "T-Spin", {8 + 71, 590}, 24, 2, WHITE);
+    }
+
+    switch(reportLinesCleared) {
+        case 1:
+            DrawTextEx(font, "SINGLE", {8 + 34, 620}, 30, 2, WHITE);
+            break;
+
+        case 2:
+            DrawTextEx(font, "DOUBLE", {8 + 20, 620}, 30, 2, WHITE);
+            break;
+
+        case 3:
+            DrawTextEx(font, "TRIPLE", {8 + 30, 620}, 30, 2, WHITE);
+            break;
+
+        case 4:
+            DrawTextEx(font, "TETRIS", {8 + 30, 620}, 30, 2, WHITE);
+            break;
+
+        default:
+            break;
+    }
+
+    if (reportB2B) {
+        DrawTextEx(font, "b2b x1.5", {8 + 82, 652}, 14, 2, WHITE);
+    }
+}
+
+/**
+ * @brief Draws the playboard and all tetrominoes.
+ * @details Aforementioned tetrominoes include the current block, the upcoming blocks,
+ * the held block and the ghost block.
+ */
+void Renderer::DrawBoard(const Game &game) {
+    PROFILE_SCOPE("DrawBoard");
+    DrawGrid(game.GetGrid());
+    DrawBlock(game.GetCurrentBlock(), 181, 16);
+
+    Block next = Block(game.Preview(0));
+    switch(next.id) {
+        case 1:
+            DrawBlock(next, 387 + 50, 48 + 50);
+            break;
+
+        case 2:
+            DrawBlock(next, 420 + 17, 48 + 65);
+            break;
+
+        default:
+            DrawBlock(next, 420 + 33, 48 + 49);
+            break;
+    }
+
+    // Later blocks are drawn smaller, centred in slots below the "Next" panel
+    int numPreviews = (game.NumPreviews() < maxSmallPreviews + 1) ? game.NumPreviews() : maxSmallPreviews + 1;
+    for (int i = 1; i < numPreviews; i++) {
+        DrawPreview(Block(game.Preview(i)), 519 + 165 / 2, 237 + 423 * (2 * i - 1) / (2 * maxSmallPreviews));
+    }
+
+    // Held block is drawn in its spawn orientation
+    Block hold = Block(game.GetHeldBlock().id);
+    switch(hold.id) {
+        case 0:
+            break;
+
+        case 1:
+            DrawBlock(hold, -123 + 50, 48 + 50);
+            break;
+
+        case 2:
+            DrawBlock(hold, -91 + 17, 48 + 65);
+            break;
+
+        default:
+            DrawBlock(hold, -91 + 33, 48 + 49);
+            break;
+    }
+
+    DrawGhost(game.GetCurrentBlock(), game.GhostRow());
+}
+
+/**
+ * @brief Displays current state of the playboard in the game.
+ * @details Locked cells are drawn from a cached texture, which is only updated when the grid changes.
+ * Render textures are stored upside down, hence the negative source height.
+ */
+void Renderer::DrawGrid(const Grid &grid) {
+    if (grid.revision != drawnRevision) {
+        UpdateGridTexture(grid);
+        drawnRevision = grid.revision;
+    }
+
+    float width = (float)gridTexture.texture.width;
+    float height = (float)gridTexture.texture.height;
+    DrawTextureRec(gridTexture.texture, {0, 0, width, -height}, {181, 16}, WHITE);
+}
+
+/**
+ * @brief Redraws the rows of the cached playboard that differ from the grid.
+ * @details Locked cells only change when a tetromino locks or rows are cleared,
+ * so usually only a few rows need to be patched.
+ */
+void Renderer::UpdateGridTexture(const Grid &grid) {
+    BeginTextureMode(gridTexture);
+
+    for (int row = 0; row < 20; row++) {
+        if (memcmp(drawnColours[row], grid.colours[row], sizeof(drawnColours[row])) == 0) {
+            continue;
+        }
+
+        for (int col = 0; col < 10; col++) {
+            int cellValue = grid.colours[row][col];
+            DrawRectangle(col * cellSize, row * cellSize, cellSize - 1, cellSize - 1, cellColours[cellValue]);
+        }
+
+        memcpy(drawnColours[row], grid.colours[row], sizeof(drawnColours[row]));
+    }
+
+    EndTextureMode();
+}
+
+/**
+ * @brief Draws the block at the specific point on the playboard with the appropriate colour.
+ * @param offsetX Offset for column in pixels (default: 181 to account for border and hold).
+ * @param offsetY Offset for row in pixels (default: 16 to account for border around playboard).
+ */
+void Renderer::DrawBlock(const Block &block, int offsetX, int offsetY) {
+    std::array<Position, 4> tiles = block.GetCellPositions();
+
+    for (Position item: tiles) {
+        DrawRectangle(item.col * cellSize + offsetX, item.row * cellSize + offsetY, cellSize - 1, cellSize - 1, cellColours[block.id]);
+    }
+}
+
+/**
+ * @brief Draws a tetromino at half size, centred on a point.
+ * @param centerX Horizontal centre in pixels.
+ * @param centerY Vertical centre in pixels.
+ */
+void Renderer::DrawPreview(const Block &block, int centerX, int centerY) {
+    std::array<Position, 4> tiles = block.GetCellPositions();
+    int size = cellSize / 2 + 1;
+    int minRow = tiles[0].row, maxRow = tiles[0].row, minCol = tiles[0].col, maxCol = tiles[0].col;
+
+    for (Position item: tiles) {
+        minRow = (item.row < minRow) ? item.row : minRow;
+        maxRow = (item.row > maxRow) ? item.row : maxRow;
+        minCol = (item.col < minCol) ? item.col : minCol;
+        maxCol = (item.col > maxCol) ? item.col : maxCol;
+    }
+
+    int offsetX = centerX - (maxCol - minCol + 1) * size / 2;
+    int offsetY = centerY - (maxRow - minRow + 1) * size / 2;
+
+    for (Position item: tiles) {
+        DrawRectangle((item.col - minCol) * size + offsetX, (item.row - minRow) * size + offsetY, size - 1, size - 1, cellColours[block.id]);
+    }
+}
+
+/**
+ * @brief Draws the "ghost block" at the specific point on the playboard with the appropriate colour.
+ * @details Highlights lowest possible legal position of the tetromino if the player were to "hard drop".
+ * Colours are just the original tetromino colours but with decreased opacity.
+ * @param ghostRow Offset for row in actual tiles (of the playboard).
+ */
+void Renderer::DrawGhost(const Block &block, int ghostRow) {
+    std::array<Position, 4> tiles = block.GetCellPositions();
+
+    for (Position item: tiles) {
+        DrawRectangle(item.col * cellSize + 181, (item.row + ghostRow) * cellSize + 16, cellSize - 1, cellSize - 1, ghostCellColours[block.id]);
+    }
+}
+
+/**
+ * @brief Draws the time spent in each phase of the main loop over the last `profileFrames` frames.
+ * @details One stacked bar per frame, newest on the right, with a line at 1/60 seconds.
+ * Only drawn while the profiler is enabled.
+ */
+void Renderer::DrawProfilerGraph() {
+    const Color phaseColours[maxProfilePhases] = {yellow, cyan, red, green, orange, blue, purple, WHITE, LIGHTGRAY, PINK, LIME, GOLD};
+    const float pixelsPerMs = 6;
+    const int left = 181, bottom = 668;
+
+    if (!profiler.enabled) {
+        return;
+    }
+
+    DrawRectangle(left - 8, bottom - 208, profileFrames * 2 + 16, 216, {0, 0, 0, 200});
+
+    for (int framesAgo = 1; framesAgo < profileFrames; framesAgo++) {
+        float y = bottom;
+
+        for (int phase = 0; phase < profiler.NumPhases(); phase++) {
+            float height = profiler.PhaseMilliseconds(framesAgo, phase) * pixelsPerMs;
+            height = (y - height < bottom - 200) ? y - (bottom - 200) : height;
+
+            DrawRectangle(left + (profileFrames - framesAgo) * 2, (int)(y - height), 2, (int)height + 1, phaseColours[phase]);
+            y -= height;
+        }
+    }
+
+    DrawLine(left, (int)(bottom - 1000.0f / ticksPerSecond * pixelsPerMs), left + profileFrames * 2, (int)(bottom - 1000.0f / ticksPerSecond * pixelsPerMs), WHITE);
+
+    for (int phase = 0; phase < profiler.NumPhases(); phase++) {
+        DrawRectangle(left, bottom - 200 + phase * 14, 10, 10, phaseColours[phase]);
+        DrawTextEx(font, profiler.PhaseName(phase), {(float)left + 14, (float)(bottom - 202 + phase * 14)}, 12, 1, WHITE);
+    }
+}
+
+/// @brief Dims the playboard and prompts the player to restart.
+void Renderer::DrawGameOver() {
+    DrawRectangle(0, 0, 692, 676, {0, 0, 0, 150});
+    DrawTextEx(font, "Game Over", {197, 274}, 50, 2, WHITE);
+    DrawTextEx(font, "Press any key", {267, 324}, 20, 2, WHITE);
+    DrawTextEx(font, "to restart", {267 + 25, 341}, 20, 2, WHITE);
+}
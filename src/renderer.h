@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <raylib.h>
+#include "game.h"
+#include "profiler.h"
+
+
+// Window dimensions in pixels
+const int screenWidth = 692;
+const int screenHeight = 756;
+
+// Upcoming blocks drawn at half size below the "Next" panel
+const int maxSmallPreviews = 4;
+
+// Text whose layout is only measured again when its value changes
+struct CachedLabel {
+    int64_t value;
+    char text[24];
+    Vector2 size;
+};
+
+class Renderer {
+    public:
+        Renderer(Font font);
+        void Unload();
+        void Draw(const Game &game, double currentTime);
+        void DrawProfilerGraph();
+
+    private:
+        Font font;
+        int cellSize;
+
+        // Pre-rendered background, panels and labels that never change
+        RenderTexture2D chromeTexture;
+        CachedLabel scoreLabel;
+        CachedLabel comboLabel;
+
+        // Cached playboard of locked cells
+        RenderTexture2D gridTexture;
+        uint8_t drawnColours[20][10];
+        uint32_t drawnRevision;
+
+        // Reporting
+        int lastRecordedLinesCleared;
+        double reportStartTime;
+        bool hasActiveReport;
+        int reportLinesCleared;
+        bool reportTSpinRegular;
+        bool reportTSpinMini;
+        bool reportB2B;
+        bool lastTSpinRegular;
+        bool lastTSpinMini;
+
+        void BakeChrome();
+        void UpdateLabel(CachedLabel &label, int64_t value, const char *format, float fontSize);
+        void DrawInterface(const Game &game);
+        void DrawReport(const Game &game, double currentTime);
+        void DrawBoard(const Game &game);
+        void DrawGrid(const Grid &grid);
+        void UpdateGridTexture(const Grid &grid);
+        void DrawBlock(const Block &block, int offsetX, int offsetY);
+        void DrawPreview(const Block &block, int centerX, int centerY);
+        void DrawGhost(const Block &block, int ghostRow);
+        void DrawGameOver();
+};
@@ -0,0 +1,333 @@
+#include <cstring>
+#include "replay.h"
+
+
+/// @brief Initialises a writer with no file open.
+ReplayWriter::ReplayWriter() {
+    file = nullptr;
+    used = 0;
+    lastTick = 0;
+}
+
+/// @brief Flushes and closes the file if it was not closed with `Close()`; the end record is left out.
+ReplayWriter::~ReplayWriter() {
+    if (file != nullptr) {
+        Flush();
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Creates a replay file and writes its header.
+ * @details Call before the game is played, and set `Game::recorder` to record it.
+ * @param path Path of the replay file, overwritten if it exists.
+ * @param game Game to record; its seed and handling are stored in the header.
+ * @param start Game state loaded on the playboard of `game`, see `Game::LoadGameState()`.
+ * @return `true` if the file was created, `false` otherwise.
+ */
+bool ReplayWriter::Open(const char *path, const Game &game, GameState start) {
+    file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    used = 0;
+    lastTick = 0;
+
+    for (char byte: replayMagic) {
+        Put((uint8_t)byte);
+    }
+
+    Put(replayVersion);
+    for (int i = 0; i < 4; i++) {
+        Put((uint8_t)(game.Seed() >> (i * 8)));
+    }
+
+    Put((uint8_t)game.handling.dasTicks);
+    Put((uint8_t)game.handling.arrTicks);
+    Put((uint8_t)game.handling.softDropTicks);
+    Put((uint8_t)start);
+
+    return true;
+}
+
+/// @brief Checks if events are being recorded.
+bool ReplayWriter::IsOpen() const {
+    return file != nullptr;
+}
+
+/// @brief Records a command or a key press/release.
+/// @param tick Tick the event was applied on, see `Game::CurrentTick()`.
+/// @param code `Command` value or `ReplayEvent` code.
+void ReplayWriter::Record(uint64_t tick, uint8_t code) {
+    if (file != nullptr) {
+        PutEvent(tick, code);
+    }
+}
+
+/// @brief Records a placement locked by `Game::Place()`.
+/// @param tick Tick the placement was locked on.
+/// @param placement The placement.
+void ReplayWriter::RecordPlace(uint64_t tick, const Placement &placement) {
+    if (file != nullptr) {
+        PutEvent(tick, (uint8_t)ReplayEvent::Place);
+        Put((uint8_t)(placement.block.rotationState | (placement.isTSpin ? 0x80 : 0)));
+        Put((uint8_t)(placement.block.row + 3));
+        Put((uint8_t)(placement.block.col + 3));
+    }
+}
+
+/**
+ * @brief Writes the end record and closes the file.
+ * @details The final score and lines cleared let readers check that a replay reproduces the game.
+ * @param tick Final tick of the game.
+ * @param score Final score.
+ * @param linesCleared Final number of lines cleared.
+ */
+void ReplayWriter::Close(uint64_t tick, int64_t score, int linesCleared) {
+    if (file == nullptr) {
+        return;
+    }
+
+    PutEvent(tick, (uint8_t)ReplayEvent::End);
+    PutVarint((uint64_t)score);
+    PutVarint((uint64_t)linesCleared);
+
+    Flush();
+    fclose(file);
+    file = nullptr;
+}
+
+/// @brief Appends a byte to the buffer, flushing it to the file once full.
+void ReplayWriter::Put(uint8_t byte) {
+    if (used == replayBufferSize) {
+        Flush();
+    }
+
+    buffer[used++] = byte;
+}
+
+/// @brief Appends an unsigned integer, 7 bits per byte with the high bit set on every byte but the last.
+void ReplayWriter::PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+        Put((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    Put((uint8_t)value);
+}
+
+/// @brief Appends the header byte of a record and the tick delta that does not fit in it.
+void ReplayWriter::PutEvent(uint64_t tick, uint8_t code) {
+    uint64_t delta = tick - lastTick;
+    lastTick = tick;
+
+    if (delta < 15) {
+        Put((uint8_t)(delta << 4 | code));
+    } else {
+        Put((uint8_t)(15 << 4 | code));
+        PutVarint(delta - 15);
+    }
+}
+
+/// @brief Writes the buffer to the file.
+void ReplayWriter::Flush() {
+    if (used > 0) {
+        fwrite(buffer, 1, used, file);
+        used = 0;
+    }
+}
+
+/// @brief Initialises a reader with no file open.
+ReplayReader::ReplayReader() {
+    seed = 0;
+    handling = defaultHandling;
+    start = GameState::TripleTSpin;
+    file = nullptr;
+    used = 0;
+    available = 0;
+    lastTick = 0;
+}
+
+/// @brief Closes the file.
+ReplayReader::~ReplayReader() {
+    if (file != nullptr) {
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Opens a replay file and reads its header.
+ * @param path Path of the replay file.
+ * @return `true` if the file is a replay of a supported version, `false` otherwise.
+ */
+bool ReplayReader::Open(const char *path) {
+    file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint8_t header[13];
+    for (uint8_t &byte: header) {
+        if (!Get(byte)) {
+            return false;
+        }
+    }
+
+    if (memcmp(header, replayMagic, sizeof(replayMagic)) != 0 || header[4] != replayVersion ||
+        header[12] > (uint8_t)GameState::SingleTSpinMini) {
+        return false;
+    }
+
+    seed = (uint32_t)header[5] | (uint32_t)header[6] << 8 | (uint32_t)header[7] << 16 | (uint32_t)header[8] << 24;
+    handling.dasTicks = header[9];
+    handling.arrTicks = header[10];
+    handling.softDropTicks = header[11];
+    start = (GameState)header[12];
+    return true;
+}
+
+/**
+ * @brief Decodes the next record.
+ * @param entry Decoded record; `placement` is only set for `ReplayEvent::Place`, and `score` and
+ * `linesCleared` only for `ReplayEvent::End`.
+ * @return `true` if a record was read, `false` at the end of the file or if the file is truncated.
+ */
+bool ReplayReader::Next(ReplayEntry &entry) {
+    uint8_t byte;
+    if (!Get(byte)) {
+        return false;
+    }
+
+    uint64_t delta = byte >> 4;
+    if (delta == 15) {
+        uint64_t rest;
+        if (!GetVarint(rest)) {
+            return false;
+        }
+        delta += rest;
+    }
+
+    lastTick += delta;
+    entry.tick = lastTick;
+    entry.code = byte & 0x0F;
+
+    if (entry.code == (uint8_t)ReplayEvent::Place) {
+        uint8_t state, row, col;
+        if (!Get(state) || !Get(row) || !Get(col)) {
+            return false;
+        }
+
+        entry.placement.block.rotationState = (int8_t)(state & 0x03);
+        entry.placement.block.row = (int8_t)(row - 3);
+        entry.placement.block.col = (int8_t)(col - 3);
+        entry.placement.isTSpin = (state & 0x80) != 0;
+        entry.placement.tSpinType = false;
+    } else if (entry.code == (uint8_t)ReplayEvent::End) {
+        uint64_t score, lines;
+        if (!GetVarint(score) || !GetVarint(lines)) {
+            return false;
+        }
+
+        entry.score = (int64_t)score;
+        entry.linesCleared = (int)lines;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Drives a game through every recorded event.
+ * @details Events are applied on the tick they were recorded on, in the order they were recorded,
+ * ticking the game in between. The recorded handling and starting game state are applied to the game first.
+ * @param game Game created with `seed` that has not been played yet.
+ * @param end The end record, if the replay has one.
+ * @return `true` if the replay is complete and the final score and lines cleared match the recording.
+ */
+bool ReplayReader::Play(Game &game, ReplayEntry &end) {
+    ReplayEntry entry;
+    game.handling = handling;
+    game.LoadGameState(start);
+
+    while (Next(entry)) {
+        while (game.CurrentTick() < entry.tick) {
+            game.Tick();
+        }
+
+        switch((ReplayEvent)entry.code) {
+            case ReplayEvent::SoftDropPressed:
+                game.Press(Command::SoftDrop);
+                break;
+
+            case ReplayEvent::SoftDropReleased:
+                game.Release(Command::SoftDrop);
+                break;
+
+            case ReplayEvent::LeftPressed:
+                game.Press(Command::MoveLeft);
+                break;
+
+            case ReplayEvent::LeftReleased:
+                game.Release(Command::MoveLeft);
+                break;
+
+            case ReplayEvent::RightPressed:
+                game.Press(Command::MoveRight);
+                break;
+
+            case ReplayEvent::RightReleased:
+                game.Release(Command::MoveRight);
+                break;
+
+            case ReplayEvent::Place:
+                entry.placement.block.id = game.GetCurrentBlock().id;
+                game.Place(entry.placement);
+                break;
+
+            case ReplayEvent::End:
+                end = entry;
+                return game.score == entry.score && game.linesCleared == entry.linesCleared;
+
+            default:
+                game.Execute((Command)entry.code);
+                break;
+        }
+    }
+
+    return false;
+}
+
+/// @brief Reads a byte from the buffer, refilling it from the file once empty.
+bool ReplayReader::Get(uint8_t &byte) {
+    if (used == available) {
+        available = (int)fread(buffer, 1, replayBufferSize, file);
+        used = 0;
+
+        if (available <= 0) {
+            available = 0;
+            return false;
+        }
+    }
+
+    byte = buffer[used++];
+    return true;
+}
+
+/// @brief Reads an unsigned integer written by `ReplayWriter::PutVarint()`.
+bool ReplayReader::GetVarint(uint64_t &value) {
+    uint8_t byte;
+    value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (!Get(byte)) {
+            return false;
+        }
+
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
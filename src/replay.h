@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include "game.h"
+#include "movegen.h"
+
+
+// Replay file layout: "TRPL", format version (1 byte), seed (4 bytes, little endian),
+// DAS, ARR and soft drop ticks (1 byte each), the `GameState` loaded before the first event (1 byte),
+// then one record per event
+// Each record starts with a byte holding the event code in the low 4 bits and the ticks since the previous
+// event in the high 4 bits; a delta of 15 or more stores 15 and the remainder as a varint after the byte
+const char replayMagic[4] = {'T', 'R', 'P', 'L'};
+const uint8_t replayVersion = 4;
+const int replayBufferSize = 4096;
+
+// Event codes; `0` to `7` are the values of `Command`
+enum class ReplayEvent : uint8_t {
+    SoftDropPressed = 8,
+    SoftDropReleased = 9,
+    Place = 10,             // followed by the rotation state | T-Spin flag << 7, then row + 3 and column + 3
+    LeftPressed = 11,
+    LeftReleased = 12,
+    RightPressed = 13,
+    RightReleased = 14,
+    End = 15                // followed by the final score and lines cleared as varints
+};
+
+// A decoded replay record
+struct ReplayEntry {
+    uint64_t tick;
+    uint8_t code;
+    Placement placement;
+    int64_t score;
+    int linesCleared;
+};
+
+class ReplayWriter {
+    public:
+        ReplayWriter();
+        ~ReplayWriter();
+        bool Open(const char *path, const Game &game, GameState start);
+        bool IsOpen() const;
+        void Record(uint64_t tick, uint8_t code);
+        void RecordPlace(uint64_t tick, const Placement &placement);
+        void Close(uint64_t tick, int64_t score, int linesCleared);
+
+    private:
+        FILE *file;
+        uint8_t buffer[replayBufferSize];
+        int used;
+        uint64_t lastTick;
+        void Put(uint8_t byte);
+        void PutVarint(uint64_t value);
+        void PutEvent(uint64_t tick, uint8_t code);
+        void Flush();
+};
+
+class ReplayReader {
+    public:
+        uint32_t seed;
+        Handling handling;
+        GameState start;
+        ReplayReader();
+        ~ReplayReader();
+        bool Open(const char *path);
+        bool Next(ReplayEntry &entry);
+        bool Play(Game &game, ReplayEntry &end);
+
+    private:
+        FILE *file;
+        uint8_t buffer[replayBufferSize];
+        int used;
+        int available;
+        uint64_t lastTick;
+        bool Get(uint8_t &byte);
+        bool GetVarint(uint64_t &value);
+};
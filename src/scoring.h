@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Kinds of spin a lock is scored as, the first index of the score tables
+enum class SpinType : uint8_t {
+    None,
+    Mini,
+    Regular
+};
+
+const int numSpinTypes = 3;
+
+// Points of a scoring preset, before the level multiplier
+// `clearPoints`: per spin type and rows cleared, `0` rows being a spin without a line clear
+// With `backToBack`, difficult clears (Tetrises and T-Spins with lines) that continue a back-to-back chain
+// are multiplied by `b2bNumerator / b2bDenominator`, rounded down; without it no chain is ever started
+struct ScoringRules {
+    int64_t clearPoints[numSpinTypes][5];
+    bool backToBack;
+    int64_t b2bNumerator;
+    int64_t b2bDenominator;
+    int64_t comboPoints;        // per combo step
+    int64_t softDropPoints;     // per cell
+    int64_t hardDropPoints;     // per cell
+};
+
+// Guideline scoring, the rules the game has always used
+constexpr ScoringRules guidelineScoring = {
+    {
+        {0, 100, 300, 500, 800},
+        {100, 200, 400, 1600, 800},
+        {400, 800, 1200, 1600, 800}
+    },
+    true, 3, 2, 50, 1, 2
+};
+
+// Classic scoring: no T-Spin bonus, back-to-back or combo, and no points for hard drops
+constexpr ScoringRules classicScoring = {
+    {
+        {0, 40, 100, 300, 1200},
+        {0, 40, 100, 300, 1200},
+        {0, 40, 100, 300, 1200}
+    },
+    false, 1, 1, 0, 1, 0
+};
+
+// Preset the game is built with, e.g. `-DSCORING_RULES=classicScoring`
+#ifndef SCORING_RULES
+    #define SCORING_RULES guidelineScoring
+#endif
+
+// Outcome of a lock, per state of the back-to-back chain before it (`[0]` inactive, `[1]` active)
+struct ScoreEntry {
+    int64_t points[2];
+    bool b2b[2];                // whether the clear is a back-to-back
+    bool chain[2];              // state of the chain after the clear
+    bool tSpinRegular;
+    bool tSpinMini;
+};
+
+// Every lock outcome of a preset, indexed by spin type and rows cleared
+struct ScoreTable {
+    ScoreEntry clears[numSpinTypes][5];
+    int64_t comboPoints;
+    int64_t softDropPoints;
+    int64_t hardDropPoints;
+};
+
+/**
+ * @brief Resolves the rules of a preset into the outcome of every lock.
+ * @details A T-Spin triple always counts as regular, and a Tetris is never a T-Spin. Clears without a
+ * spin break the back-to-back chain, while locks without a line clear leave it as it is. Without
+ * `ScoringRules::backToBack`, no clear is difficult, so the chain never starts.
+ */
+constexpr ScoreTable BuildScoreTable(const ScoringRules &rules) {
+    ScoreTable table = {};
+
+    for (int spin = 0; spin < numSpinTypes; spin++) {
+        for (int rows = 0; rows <= 4; rows++) {
+            ScoreEntry &entry = table.clears[spin][rows];
+
+            SpinType scored = (rows == 4) ? SpinType::None :
+                              (rows == 3 && spin != (int)SpinType::None) ? SpinType::Regular : (SpinType)spin;
+            bool difficult = rules.backToBack && rows > 0 && (rows == 4 || scored != SpinType::None);
+            int64_t points = rules.clearPoints[spin][rows];
+
+            for (int chain = 0; chain < 2; chain++) {
+                entry.b2b[chain] = difficult && chain == 1;
+                entry.points[chain] = entry.b2b[chain] ? points * rules.b2bNumerator / rules.b2bDenominator : points;
+                entry.chain[chain] = (rows == 0) ? chain == 1 : difficult;
+            }
+
+            entry.tSpinRegular = scored == SpinType::Regular;
+            entry.tSpinMini = scored == SpinType::Mini;
+        }
+    }
+
+    table.comboPoints = rules.comboPoints;
+    table.softDropPoints = rules.softDropPoints;
+    table.hardDropPoints = rules.hardDropPoints;
+
+    return table;
+}
+
+constexpr ScoreTable scoreTable = BuildScoreTable(SCORING_RULES);
@@ -0,0 +1,333 @@
+#include <cstdlib>
+#include "stackfeatures.h"
+#include "profiler.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Playable columns and the pairs of neighbouring cells, including the walls, in a row of `Grid::rows`
+const uint16_t playableMask = (uint16_t)~emptyRow;
+const uint16_t rowPairMask = (uint16_t)(0x7FF << wallBits);
+
+/**
+ * @brief Computes the features of a single playboard one cell at a time.
+ * @details Reference implementation of `ComputeStackFeatures()`, also used when no vector kernel is available.
+ * @param grid Playboard to measure.
+ * @return Features of the stack.
+ */
+StackFeatures ComputeStackFeaturesScalar(const Grid &grid) {
+    StackFeatures features = {};
+
+    for (int col = 0; col < 10; col++) {
+        bool seen = false;
+        bool holeBelow = false;
+        int wellDepth = 0;
+
+        for (int row = 0; row < 20; row++) {
+            bool filled = !grid.IsCellEmpty(row, col);
+            bool filledAbove = (row > 0) && !grid.IsCellEmpty(row - 1, col);
+            bool leftFilled = (col == 0) || !grid.IsCellEmpty(row, col - 1);
+            bool rightFilled = (col == 9) || !grid.IsCellEmpty(row, col + 1);
+
+            if (filled && !seen) {
+                features.heights[col] = (uint8_t)(20 - row);
+                seen = true;
+            } else if (!filled && seen) {
+                features.holes++;
+            }
+
+            if (filled != filledAbove) {
+                features.columnTransitions++;
+            }
+
+            if (!filled && !seen && leftFilled && rightFilled) {
+                wellDepth++;
+                features.wells += wellDepth;
+            } else {
+                wellDepth = 0;
+            }
+        }
+
+        // The floor
+        if (grid.IsCellEmpty(19, col)) {
+            features.columnTransitions++;
+        }
+
+        for (int row = 19; row >= 0; row--) {
+            if (grid.IsCellEmpty(row, col)) {
+                holeBelow = holeBelow || (20 - row < features.heights[col]);
+            } else if (holeBelow) {
+                features.coveredCells++;
+            }
+        }
+
+        features.aggregateHeight += features.heights[col];
+        if (col > 0) {
+            features.bumpiness += abs(features.heights[col] - features.heights[col - 1]);
+        }
+    }
+
+    for (int row = 0; row < 20; row++) {
+        for (int col = 0; col <= 10; col++) {
+            bool leftFilled = (col == 0) || !grid.IsCellEmpty(row, col - 1);
+            bool filled = (col == 10) || !grid.IsCellEmpty(row, col);
+
+            if (filled != leftFilled) {
+                features.rowTransitions++;
+            }
+        }
+    }
+
+    return features;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// 16-bit lanes of a vector register, one playboard per lane
+#if defined(__AVX2__)
+struct Lanes {
+    typedef __m256i Vec;
+    static const int count = 16;
+    static Vec Load(const uint16_t *values) { return _mm256_load_si256((const __m256i *)values); }
+    static void Store(uint16_t *values, Vec a) { _mm256_store_si256((__m256i *)values, a); }
+    static Vec Set(uint16_t value) { return _mm256_set1_epi16((short)value); }
+    static Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static Vec AndNot(Vec a, Vec b) { return _mm256_andnot_si256(b, a); }
+    static Vec Or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_epi16(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm256_sub_epi16(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm256_max_epi16(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_min_epi16(a, b); }
+    static Vec ShiftLeft(Vec a, int bits) { return _mm256_slli_epi16(a, bits); }
+    static Vec ShiftRight(Vec a, int bits) { return _mm256_srli_epi16(a, bits); }
+    static bool Any(Vec a) { return !_mm256_testz_si256(a, a); }
+};
+#else
+struct Lanes {
+    typedef __m128i Vec;
+    static const int count = 8;
+    static Vec Load(const uint16_t *values) { return _mm_load_si128((const __m128i *)values); }
+    static void Store(uint16_t *values, Vec a) { _mm_store_si128((__m128i *)values, a); }
+    static Vec Set(uint16_t value) { return _mm_set1_epi16((short)value); }
+    static Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static Vec AndNot(Vec a, Vec b) { return _mm_andnot_si128(b, a); }
+    static Vec Or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_epi16(a, b); }
+    static Vec Sub(Vec a, Vec b) { return _mm_sub_epi16(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm_max_epi16(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm_min_epi16(a, b); }
+    static Vec ShiftLeft(Vec a, int bits) { return _mm_slli_epi16(a, bits); }
+    static Vec ShiftRight(Vec a, int bits) { return _mm_srli_epi16(a, bits); }
+    static bool Any(Vec a) { return _mm_movemask_epi8(_mm_cmpeq_epi16(a, _mm_setzero_si128())) != 0xFFFF; }
+};
+#endif
+
+typedef Lanes::Vec Vec;
+
+/// @brief Number of set bits of each byte of every lane (SWAR, as there is no 16-bit popcount instruction).
+/// @details The two bytes of a lane are only added by `FinishCount()`, so the counts of up to 31 rows
+/// can be summed first.
+static inline Vec ByteCounts(Vec a) {
+    a = Lanes::Sub(a, Lanes::And(Lanes::ShiftRight(a, 1), Lanes::Set(0x5555)));
+    a = Lanes::Add(Lanes::And(a, Lanes::Set(0x3333)), Lanes::And(Lanes::ShiftRight(a, 2), Lanes::Set(0x3333)));
+    return Lanes::And(Lanes::Add(a, Lanes::ShiftRight(a, 4)), Lanes::Set(0x0F0F));
+}
+
+/// @brief Adds the two byte counts of every lane summed from `ByteCounts()`.
+static inline Vec FinishCount(Vec a) {
+    return Lanes::Add(Lanes::And(a, Lanes::Set(0x00FF)), Lanes::ShiftRight(a, 8));
+}
+
+/**
+ * @brief Computes the features of `Lanes::count` playboards at once, one row of every playboard per step.
+ * @details Most features are counts of set bits of masks built from whole rows, e.g. a cell is a hole if
+ * a cell above it was filled (`seen`). Column heights are kept bit-sliced: bit `k` of the height of every
+ * column is a mask of its own, set on the row the column is first seen. Wells are summed from masks of the
+ * cells ending runs of 1, 2, ... well cells, which are only kept while a lane still has such a run.
+ * @param rows Rows of the playboards, transposed so that `rows[row][lane]` is row `row` of playboard `lane`.
+ * @param features Features of each playboard, for `numGrids` lanes.
+ */
+static void ComputeLanes(const uint16_t rows[20][Lanes::count], StackFeatures features[], int numGrids) {
+    const Vec playable = Lanes::Set(playableMask);
+    const Vec rowPairs = Lanes::Set(rowPairMask);
+    const Vec one = Lanes::Set(1);
+    const Vec zero = Lanes::Set(0);
+    Vec seen = zero;
+    Vec previous = zero;
+    Vec holes = zero;
+    Vec coveredCells = zero;
+    Vec rowTransitions = zero;
+    Vec columnTransitions = zero;
+    Vec wells = zero;
+    Vec heightBits[5];
+    Vec holeRows[20];
+    Vec wellRuns[21];
+    int numWellRuns = 0;
+
+    for (int bit = 0; bit < 5; bit++) {
+        heightBits[bit] = zero;
+    }
+
+    for (int row = 0; row < 20; row++) {
+        Vec walled = Lanes::Load(rows[row]);
+        Vec cells = Lanes::And(walled, playable);
+        Vec firstSeen = Lanes::AndNot(cells, seen);
+
+        for (int bit = 0; bit < 5; bit++) {
+            if (((20 - row) >> bit) & 1) {
+                heightBits[bit] = Lanes::Or(heightBits[bit], firstSeen);
+            }
+        }
+
+        holeRows[row] = Lanes::AndNot(seen, cells);
+        holes = Lanes::Add(holes, ByteCounts(holeRows[row]));
+        rowTransitions = Lanes::Add(rowTransitions,
+                                    ByteCounts(Lanes::And(Lanes::Xor(walled, Lanes::ShiftLeft(walled, 1)), rowPairs)));
+        columnTransitions = Lanes::Add(columnTransitions, ByteCounts(Lanes::Xor(cells, previous)));
+        previous = cells;
+
+        // Open cells, i.e. with nothing above them, between filled cells or walls
+        Vec wellCells = Lanes::AndNot(Lanes::And(Lanes::ShiftLeft(walled, 1), Lanes::ShiftRight(walled, 1)),
+                                      Lanes::Or(walled, seen));
+        wellCells = Lanes::And(wellCells, playable);
+        seen = Lanes::Or(seen, cells);
+
+        // `wellRuns[depth]`: well cells at the bottom of `depth + 1` well cells in a row; a well cell adds
+        // its depth to `wells`, i.e. it is counted once in each run it ends
+        for (int depth = numWellRuns; depth > 0; depth--) {
+            wellRuns[depth] = Lanes::And(wellRuns[depth - 1], wellCells);
+        }
+        wellRuns[0] = wellCells;
+        numWellRuns = (numWellRuns < 20) ? numWellRuns + 1 : 20;
+
+        while (numWellRuns > 0 && !Lanes::Any(wellRuns[numWellRuns - 1])) {
+            numWellRuns--;
+        }
+
+        // A byte counts at most 5 columns of 20 runs, but the rows of a stack can hold more, so each row is finished
+        Vec rowWells = zero;
+        for (int depth = 0; depth < numWellRuns; depth++) {
+            rowWells = Lanes::Add(rowWells, ByteCounts(wellRuns[depth]));
+        }
+        wells = Lanes::Add(wells, FinishCount(rowWells));
+    }
+
+    // The floor counts as filled
+    columnTransitions = Lanes::Add(columnTransitions, ByteCounts(Lanes::AndNot(playable, previous)));
+
+    Vec holesBelow = zero;
+    for (int row = 19; row >= 0; row--) {
+        Vec cells = Lanes::And(Lanes::Load(rows[row]), playable);
+        coveredCells = Lanes::Add(coveredCells, ByteCounts(Lanes::And(cells, holesBelow)));
+        holesBelow = Lanes::Or(holesBelow, holeRows[row]);
+    }
+
+    Vec heights[10];
+    Vec aggregateHeight = zero;
+    Vec bumpiness = zero;
+
+    for (int col = 0; col < 10; col++) {
+        heights[col] = zero;
+
+        for (int bit = 0; bit < 5; bit++) {
+            Vec value = Lanes::And(Lanes::ShiftRight(heightBits[bit], col + wallBits), one);
+            heights[col] = Lanes::Add(heights[col], Lanes::ShiftLeft(value, bit));
+        }
+
+        aggregateHeight = Lanes::Add(aggregateHeight, heights[col]);
+        if (col > 0) {
+            bumpiness = Lanes::Add(bumpiness, Lanes::Sub(Lanes::Max(heights[col], heights[col - 1]),
+                                                         Lanes::Min(heights[col], heights[col - 1])));
+        }
+    }
+
+    holes = FinishCount(holes);
+    coveredCells = FinishCount(coveredCells);
+    rowTransitions = FinishCount(rowTransitions);
+    columnTransitions = FinishCount(columnTransitions);
+
+    alignas(32) uint16_t lanes[17][Lanes::count];
+    for (int col = 0; col < 10; col++) {
+        Lanes::Store(lanes[col], heights[col]);
+    }
+    Lanes::Store(lanes[10], aggregateHeight);
+    Lanes::Store(lanes[11], holes);
+    Lanes::Store(lanes[12], coveredCells);
+    Lanes::Store(lanes[13], bumpiness);
+    Lanes::Store(lanes[14], rowTransitions);
+    Lanes::Store(lanes[15], columnTransitions);
+    Lanes::Store(lanes[16], wells);
+
+    for (int lane = 0; lane < numGrids; lane++) {
+        StackFeatures &result = features[lane];
+
+        for (int col = 0; col < 10; col++) {
+            result.heights[col] = (uint8_t)lanes[col][lane];
+        }
+        result.aggregateHeight = lanes[10][lane];
+        result.holes = lanes[11][lane];
+        result.coveredCells = lanes[12][lane];
+        result.bumpiness = lanes[13][lane];
+        result.rowTransitions = lanes[14][lane];
+        result.columnTransitions = lanes[15][lane];
+        result.wells = lanes[16][lane];
+    }
+}
+
+#endif
+
+/**
+ * @brief Computes the features of a batch of playboards.
+ * @details Uses AVX2 (16 playboards per step) when compiled with `-mavx2`, SSE2 (8 per step) on any other
+ * x86-64 build and `ComputeStackFeaturesScalar()` elsewhere; every kernel gives the same results.
+ * @param grids Playboards to measure.
+ * @param numGrids Number of playboards.
+ * @param features Features of each playboard, in the same order.
+ */
+void ComputeStackFeatures(const Grid grids[], int numGrids, StackFeatures features[]) {
+    PROFILE_SCOPE("ComputeStackFeatures");
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    static const Grid emptyGrid;
+    alignas(32) uint16_t rows[20][Lanes::count];
+    const Grid *sources[Lanes::count];
+
+    for (int first = 0; first < numGrids; first += Lanes::count) {
+        int numLanes = (numGrids - first < Lanes::count) ? numGrids - first : Lanes::count;
+
+        // Missing playboards of the last batch are left empty
+        for (int lane = 0; lane < Lanes::count; lane++) {
+            sources[lane] = (lane < numLanes) ? &grids[first + lane] : &emptyGrid;
+        }
+
+        for (int row = 0; row < 20; row++) {
+            for (int lane = 0; lane < Lanes::count; lane++) {
+                rows[row][lane] = sources[lane] -> rows[row];
+            }
+        }
+
+        ComputeLanes(rows, features + first, numLanes);
+    }
+#else
+    for (int i = 0; i < numGrids; i++) {
+        features[i] = ComputeStackFeaturesScalar(grids[i]);
+    }
+#endif
+}
+
+/// @brief Name of the kernel `ComputeStackFeatures()` was compiled with.
+const char *StackFeaturesKernel() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include "grid.h"
+
+
+// Shape of the stack on a playboard, as used by bot evaluation functions
+// `heights`: rows from the floor up to the highest filled cell of each column; `aggregateHeight`: their sum
+// `holes`: empty cells below a filled cell of the same column; `coveredCells`: filled cells above a hole
+// `bumpiness`: sum of the height differences of neighbouring columns
+// `rowTransitions`/`columnTransitions`: filled/empty changes along every row (walls count as filled) and
+// down every column (the floor counts as filled, above the playboard as empty)
+// `wells`: for every run of open cells with filled cells or walls on both sides, 1 + 2 + ... + its depth
+struct StackFeatures {
+    uint8_t heights[10];
+    int aggregateHeight;
+    int holes;
+    int coveredCells;
+    int bumpiness;
+    int rowTransitions;
+    int columnTransitions;
+    int wells;
+};
+
+void ComputeStackFeatures(const Grid grids[], int numGrids, StackFeatures features[]);
+StackFeatures ComputeStackFeaturesScalar(const Grid &grid);
+const char *StackFeaturesKernel();
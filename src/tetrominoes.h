@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include "position.h"
+
+
+// Tetromino ids; `0` is reserved for an empty cell or no tetromino
+// 1: O, 2: I, 3: S, 4: Z, 5: L, 6: J, 7: T
+const int numTetrominoes = 7;
+
+// Number of distinct rotation states of each tetromino
+constexpr int tetrominoRotations[8] = {1, 1, 4, 4, 4, 4, 4, 4};
+
+// Tiles of each rotation state within a 4x4 bounding box
+// For the T-Block, the center tile is always the last tile (see `Game::TSpinType()`)
+constexpr Position tetrominoCells[8][4][4] = {
+    {},
+
+    // O
+    {
+        {Position(0, 0), Position(0, 1), Position(1, 0), Position(1, 1)},
+    },
+
+    // I
+    {
+        {Position(1, 0), Position(1, 1), Position(1, 2), Position(1, 3)},
+        {Position(0, 2), Position(1, 2), Position(2, 2), Position(3, 2)},
+        {Position(2, 3), Position(2, 2), Position(2, 1), Position(2, 0)},
+        {Position(3, 1), Position(2, 1), Position(1, 1), Position(0, 1)},
+    },
+
+    // S
+    {
+        {Position(1, 0), Position(1, 1), Position(0, 1), Position(0, 2)},
+        {Position(0, 1), Position(1, 1), Position(1, 2), Position(2, 2)},
+        {Position(1, 2), Position(1, 1), Position(2, 1), Position(2, 0)},
+        {Position(2, 1), Position(1, 1), Position(1, 0), Position(0, 0)},
+    },
+
+    // Z
+    {
+        {Position(0, 0), Position(0, 1), Position(1, 1), Position(1, 2)},
+        {Position(0, 2), Position(1, 2), Position(1, 1), Position(2, 1)},
+        {Position(2, 2), Position(2, 1), Position(1, 1), Position(1, 0)},
+        {Position(2, 0), Position(1, 0), Position(1, 1), Position(0, 1)},
+    },
+
+    // L
+    {
+        {Position(0, 2), Position(1, 2), Position(1, 1), Position(1, 0)},
+        {Position(2, 2), Position(0, 1), Position(1, 1), Position(2, 1)},
+        {Position(2, 0), Position(1, 2), Position(1, 1), Position(1, 0)},
+        {Position(0, 0), Position(2, 1), Position(1, 1), Position(0, 1)},
+    },
+
+    // J
+    {
+        {Position(0, 0), Position(1, 0), Position(1, 1), Position(1, 2)},
+        {Position(0, 2), Position(0, 1), Position(1, 1), Position(2, 1)},
+        {Position(2, 2), Position(1, 2), Position(1, 1), Position(1, 0)},
+        {Position(2, 0), Position(2, 1), Position(1, 1), Position(0, 1)},
+    },
+
+    // T
+    {
+        {Position(1, 0), Position(0, 1), Position(1, 2), Position(1, 1)},
+        {Position(0, 1), Position(1, 2), Position(2, 1), Position(1, 1)},
+        {Position(1, 2), Position(2, 1), Position(1, 0), Position(1, 1)},
+        {Position(2, 1), Position(1, 0), Position(0, 1), Position(1, 1)},
+    },
+};
+
+// Offset of the bounding box when a tetromino spawns, centred at the top of the playboard
+constexpr Position spawnOffsets[8] = {
+    Position(0, 0),
+    Position(0, 4),
+    Position(-1, 3),
+    Position(0, 3),
+    Position(0, 3),
+    Position(0, 3),
+    Position(0, 3),
+    Position(0, 3),
+};
+
+// Bounding box row masks of each rotation state for bitboard collision, where bit `n` is box column `n`
+// Bottoms are the lowest occupied box row of each box column, `-1` if the column is empty
+struct ShapeTable {
+    uint16_t masks[8][4][4];
+    int8_t bottoms[8][4][4];
+};
+
+constexpr ShapeTable BuildShapeTable() {
+    ShapeTable table = {};
+
+    for (int id = 0; id <= numTetrominoes; id++) {
+        for (int rotation = 0; rotation < 4; rotation++) {
+            for (int boxCol = 0; boxCol < 4; boxCol++) {
+                table.bottoms[id][rotation][boxCol] = -1;
+            }
+        }
+    }
+
+    for (int id = 1; id <= numTetrominoes; id++) {
+        for (int rotation = 0; rotation < tetrominoRotations[id]; rotation++) {
+            for (int tile = 0; tile < 4; tile++) {
+                const Position &item = tetrominoCells[id][rotation][tile];
+                table.masks[id][rotation][item.row] |= (uint16_t)(1 << item.col);
+
+                if (item.row > table.bottoms[id][rotation][item.col]) {
+                    table.bottoms[id][rotation][item.col] = (int8_t)item.row;
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+constexpr ShapeTable tetrominoShapes = BuildShapeTable();
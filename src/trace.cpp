@@ -0,0 +1,102 @@
+#include <chrono>
+#include "trace.h"
+
+
+/// @brief Initialises a trace with no file open; records are only kept once opened.
+EventTrace::EventTrace() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    running.store(false, std::memory_order_relaxed);
+    file = nullptr;
+}
+
+/// @brief Flushes the remaining records and closes the file.
+EventTrace::~EventTrace() {
+    Close();
+}
+
+/**
+ * @brief Creates a trace file, writes its header and starts the flush thread.
+ * @details Set `Game::trace` to record the game.
+ * @param path Path of the trace file, overwritten if it exists.
+ * @return `true` if the file was created, `false` otherwise.
+ */
+bool EventTrace::Open(const char *path) {
+    Close();
+
+    file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint8_t header[6] = {
+        (uint8_t)traceMagic[0], (uint8_t)traceMagic[1], (uint8_t)traceMagic[2], (uint8_t)traceMagic[3],
+        traceVersion, (uint8_t)sizeof(TraceRecord)
+    };
+    fwrite(header, 1, sizeof(header), file);
+
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    running.store(true, std::memory_order_release);
+    flusher = std::thread(&EventTrace::Run, this);
+
+    return true;
+}
+
+/// @brief Checks if records are being written to a file.
+bool EventTrace::IsOpen() const {
+    return file != nullptr;
+}
+
+/// @brief Stops the flush thread, writes the remaining records and closes the file.
+void EventTrace::Close() {
+    if (file == nullptr) {
+        return;
+    }
+
+    running.store(false, std::memory_order_release);
+    flusher.join();
+
+    Flush();
+    fclose(file);
+    file = nullptr;
+}
+
+/// @brief Flush thread: writes the published records every `traceFlushMilliseconds` until closed.
+void EventTrace::Run() {
+    while (running.load(std::memory_order_acquire)) {
+        Flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(traceFlushMilliseconds));
+    }
+}
+
+/**
+ * @brief Writes every record published since the last flush, then frees their slots.
+ * @details Records dropped in the meantime are reported with a `TraceEvent::Dropped` record.
+ */
+void EventTrace::Flush() {
+    uint64_t start = tail.load(std::memory_order_relaxed);
+    uint64_t end = head.load(std::memory_order_acquire);
+
+    // The records wrap around the end of the ring at most once
+    while (start < end) {
+        uint64_t offset = start & (traceCapacity - 1);
+        uint64_t count = end - start;
+        count = (offset + count > (uint64_t)traceCapacity) ? traceCapacity - offset : count;
+
+        fwrite(records + offset, sizeof(TraceRecord), count, file);
+        start += count;
+    }
+
+    tail.store(end, std::memory_order_release);
+
+    uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+    if (lost > 0) {
+        TraceRecord record = {0, TraceEvent::Dropped, 0, 0, 0, (int32_t)lost};
+        fwrite(&record, sizeof(record), 1, file);
+    }
+
+    fflush(file);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+
+// Trace file layout: "TTRC", format version (1 byte), record size (1 byte), then `TraceRecord`s in the byte
+// order of the machine that wrote them, see `tools/trace.cpp`
+const char traceMagic[4] = {'T', 'T', 'R', 'C'};
+const uint8_t traceVersion = 1;
+
+// Records held between flushes; the game drops records rather than wait once the ring is full
+const int traceCapacity = 1 << 12;
+const int traceFlushMilliseconds = 20;
+
+// Record types and their fields
+enum class TraceEvent : uint8_t {
+    Lock = 1,           // `a` tetromino id, `b` rotation state, `c` row, `value` column
+    Kick = 2,           // `a` tetromino id, `b` rotation state before, `c` after, `value` wall kick test used
+    TSpin = 3,          // `a` center row, `b` center column, `c` `1` if regular, `value` corners filled
+    LineClear = 4,      // `a` rows cleared, `b` `SpinType`, `c` `1` if back-to-back, `value` total lines cleared
+    Combo = 5,          // `value` combo count
+    Dropped = 6         // `value` records dropped since the previous flush because the ring was full
+};
+
+struct TraceRecord {
+    uint64_t tick;
+    TraceEvent type;
+    int8_t a;
+    int8_t b;
+    int8_t c;
+    int32_t value;
+};
+
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord must not be padded");
+
+// Fixed-capacity ring of trace records, written to a file by a background thread
+// Lock-free with a single producer: only the thread that runs the game may call `Record()`
+class EventTrace {
+    public:
+        EventTrace();
+        ~EventTrace();
+        bool Open(const char *path);
+        bool IsOpen() const;
+        void Record(uint64_t tick, TraceEvent type, int a, int b, int c, int value);
+        void Close();
+
+    private:
+        TraceRecord records[traceCapacity];
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        std::atomic<uint64_t> dropped;
+        std::atomic<bool> running;
+        FILE *file;
+        std::thread flusher;
+        void Flush();
+        void Run();
+};
+
+/**
+ * @brief Appends a record without blocking; dropped if the flush thread has fallen a whole ring behind.
+ * @details Fields are truncated to the widths of `TraceRecord`, see `TraceEvent` for their meaning.
+ */
+inline void EventTrace::Record(uint64_t tick, TraceEvent type, int a, int b, int c, int value) {
+    uint64_t index = head.load(std::memory_order_relaxed);
+
+    if (index - tail.load(std::memory_order_acquire) >= (uint64_t)traceCapacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceRecord &record = records[index & (traceCapacity - 1)];
+    record.tick = tick;
+    record.type = type;
+    record.a = (int8_t)a;
+    record.b = (int8_t)b;
+    record.c = (int8_t)c;
+    record.value = value;
+
+    head.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,129 @@
+#include <new>
+#include "transposition.h"
+
+
+// Layout of a packed entry: value in bits 0-39, depth + 1 in bits 40-47 (so a used entry is never `0`),
+// move in bits 48-63
+const int valueBits = 40;
+const uint64_t valueMask = (1ull << valueBits) - 1;
+
+/// @brief Packs an entry into a single word.
+static uint64_t Pack(const TranspositionEntry &entry) {
+    return ((uint64_t)entry.value & valueMask) | ((uint64_t)(entry.depth + 1) << valueBits) |
+           ((uint64_t)(entry.move & 0xFFFF) << 48);
+}
+
+/// @brief Unpacks a word written by `Pack()`.
+static TranspositionEntry Unpack(uint64_t data) {
+    TranspositionEntry entry;
+    entry.value = (int64_t)(data << (64 - valueBits)) >> (64 - valueBits);
+    entry.depth = (int)((data >> valueBits) & 0xFF) - 1;
+    entry.move = (int)(data >> 48);
+
+    return entry;
+}
+
+/**
+ * @brief Allocates an empty table.
+ * @param megabytes Memory to use; rounded down to a power of two number of buckets, at least one.
+ */
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    size_t numBuckets = 1;
+    while (numBuckets * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        numBuckets *= 2;
+    }
+
+    // Over-aligned `new` is only guaranteed from C++17, so the buckets are aligned by hand
+    storage = new uint8_t[numBuckets * sizeof(Bucket) + alignof(Bucket)];
+    uintptr_t address = (uintptr_t)storage;
+    address = (address + alignof(Bucket) - 1) & ~(uintptr_t)(alignof(Bucket) - 1);
+
+    buckets = new((void *)address) Bucket[numBuckets];
+    mask = numBuckets - 1;
+
+    Clear();
+}
+
+/// @brief Frees the table.
+TranspositionTable::~TranspositionTable() {
+    delete[] storage;
+}
+
+/**
+ * @brief Looks up the result stored for a game state.
+ * @details Safe to call while other threads store results.
+ * @param key Hash of the game state.
+ * @param entry Set to the stored result if there is one.
+ * @return `true` if a result was found, `false` otherwise.
+ */
+bool TranspositionTable::Probe(uint64_t key, TranspositionEntry &entry) const {
+    const Bucket &bucket = buckets[key & mask];
+
+    for (const Slot &slot: bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if (data != 0 && (check ^ data) == key) {
+            entry = Unpack(data);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Stores the result of a search.
+ * @details Replaces the entry of the same game state if there is one, otherwise an empty entry or
+ * the shallowest entry of the bucket, since deeper results took longer to compute.
+ * A value outside `transpositionMinValue` to `transpositionMaxValue` does not fit in an entry and is not
+ * stored, so the state is searched again rather than read back wrapped.
+ * Safe to call while other threads probe or store results.
+ * @param key Hash of the game state.
+ * @param entry Result to store.
+ */
+void TranspositionTable::Store(uint64_t key, const TranspositionEntry &entry) {
+    if (entry.value < transpositionMinValue || entry.value > transpositionMaxValue) {
+        return;
+    }
+
+    Bucket &bucket = buckets[key & mask];
+    Slot *victim = &bucket.slots[0];
+    int victimDepth = 256;
+
+    for (Slot &slot: bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if (data != 0 && (check ^ data) == key) {
+            victim = &slot;
+            break;
+        }
+
+        // Empty entries have a depth of `0`, below any stored result
+        int depth = (int)((data >> valueBits) & 0xFF);
+        if (depth < victimDepth) {
+            victim = &slot;
+            victimDepth = depth;
+        }
+    }
+
+    uint64_t data = Pack(entry);
+    victim -> data.store(data, std::memory_order_relaxed);
+    victim -> check.store(key ^ data, std::memory_order_relaxed);
+}
+
+/// @brief Empties the table. Not safe to call while other threads use it.
+void TranspositionTable::Clear() {
+    for (uint64_t i = 0; i <= mask; i++) {
+        for (Slot &slot: buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/// @brief Number of results the table can hold.
+size_t TranspositionTable::NumEntries() const {
+    return (size_t)(mask + 1) * transpositionBucketSize;
+}
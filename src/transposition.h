@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+// Entries per bucket; a bucket fills one 64-byte cache line
+const int transpositionBucketSize = 4;
+
+// Stored values are packed into 40 bits, so results outside `transpositionMinValue` to `transpositionMaxValue`
+// (+/- 2^39) are not stored, see `TranspositionTable::Store()`
+const int64_t transpositionMaxValue = (1ll << 39) - 1;
+const int64_t transpositionMinValue = -(1ll << 39);
+
+// Result of a search stored for a game state, see `Game::Hash()`
+// `value`: score or node count, within `transpositionMinValue` to `transpositionMaxValue`; `depth`: plies searched below the state, `0` to `254`;
+// `move`: index of the best move, `0` to `65535`
+struct TranspositionEntry {
+    int64_t value;
+    int depth;
+    int move;
+};
+
+// Fixed-size hash table of search results shared by any number of threads without locks
+// Every entry is two 64-bit words, the packed result and the key XOR the result, so an entry torn by two
+// threads writing at once fails the key check and reads as a miss instead of returning a wrong result
+class TranspositionTable {
+    public:
+        TranspositionTable(size_t megabytes);
+        ~TranspositionTable();
+        TranspositionTable(const TranspositionTable &) = delete;
+        TranspositionTable &operator=(const TranspositionTable &) = delete;
+        bool Probe(uint64_t key, TranspositionEntry &entry) const;
+        void Store(uint64_t key, const TranspositionEntry &entry);
+        void Clear();
+        size_t NumEntries() const;
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> data;
+        };
+
+        struct alignas(64) Bucket {
+            Slot slots[transpositionBucketSize];
+        };
+
+        uint8_t *storage;
+        Bucket *buckets;
+        uint64_t mask;
+};
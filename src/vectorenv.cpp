@@ -0,0 +1,170 @@
+#include <cstring>
+#include "profiler.h"
+#include "vectorenv.h"
+
+
+// Cells of every possible row of 10 columns, so that a row is written with a single copy
+struct RowCellsTable {
+    uint8_t cells[1 << 10][10];
+};
+
+constexpr RowCellsTable BuildRowCellsTable() {
+    RowCellsTable table = {};
+
+    for (int bits = 0; bits < (1 << 10); bits++) {
+        for (int col = 0; col < 10; col++) {
+            table.cells[bits][col] = (uint8_t)((bits >> col) & 1);
+        }
+    }
+
+    return table;
+}
+
+constexpr RowCellsTable rowCells = BuildRowCellsTable();
+
+/**
+ * @brief Creates the environments, each with a new game.
+ * @param numEnvs Number of games.
+ * @param seed Seed of the first game; episode `e` of environment `i` is dealt from `seed + i + e * numEnvs`,
+ * so every episode is reproducible and no two episodes share a sequence.
+ * @param numPreviews Upcoming tetrominoes in each observation, from `1` to `maxPreviews`.
+ * @param ticksPerStep Simulation ticks after each action, i.e. how far gravity and lock delay advance per step.
+ * @param maxSteps Steps before an episode is ended even if the game is not over, `0` for no limit.
+ */
+VectorEnv::VectorEnv(int numEnvs, uint32_t seed, int numPreviews, int ticksPerStep, int maxSteps) {
+    this -> numEnvs = numEnvs;
+    this -> numPreviews = (numPreviews < 1) ? 1 : (numPreviews > maxPreviews) ? maxPreviews : numPreviews;
+    this -> ticksPerStep = ticksPerStep;
+    this -> maxSteps = maxSteps;
+    this -> seed = seed;
+
+    games = std::vector<Game>(numEnvs);
+    scores = std::vector<int64_t>(numEnvs, 0);
+    steps = std::vector<int>(numEnvs, 0);
+    episodes = std::vector<uint32_t>(numEnvs, 0);
+
+    for (int env = 0; env < numEnvs; env++) {
+        Restart(env);
+    }
+}
+
+/// @brief Number of environments.
+int VectorEnv::NumEnvs() const {
+    return numEnvs;
+}
+
+/// @brief Upcoming tetrominoes written per environment to `EnvBuffers::queues`.
+int VectorEnv::NumPreviews() const {
+    return numPreviews;
+}
+
+/// @brief Read-only access to the game of an environment, e.g. to render it.
+const Game &VectorEnv::GetGame(int env) const {
+    return games[env];
+}
+
+/// @brief Starts the next episode of an environment on an empty playboard.
+void VectorEnv::Restart(int env) {
+    games[env] = Game(seed + (uint32_t)env + episodes[env] * (uint32_t)numEnvs, numPreviews);
+    games[env].LoadGameState(GameState::Empty);
+
+    scores[env] = 0;
+    steps[env] = 0;
+    episodes[env]++;
+}
+
+/**
+ * @brief Restarts every environment and writes their first observations.
+ * @details Rewards are `0` and no environment is done.
+ * @param buffers Buffers to write to.
+ */
+void VectorEnv::Reset(const EnvBuffers &buffers) {
+    for (int env = 0; env < numEnvs; env++) {
+        Restart(env);
+        Observe(env, buffers);
+
+        if (buffers.rewards != nullptr) {
+            buffers.rewards[env] = 0;
+        }
+        if (buffers.dones != nullptr) {
+            buffers.dones[env] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Applies one action to every environment and writes the results.
+ * @details Each action is applied with `Game::Execute()`, followed by `ticksPerStep` ticks. The reward is the
+ * score gained, as awarded by `Game::UpdateScore()`. An environment whose game is over, or that reached
+ * `maxSteps`, is done: it is restarted and its observation is the first of the next episode.
+ * @param actions One `Command` per environment, from `0` to `numEnvActions - 1`; other values do nothing.
+ * @param buffers Buffers to write to.
+ */
+void VectorEnv::Step(const uint8_t actions[], const EnvBuffers &buffers) {
+    PROFILE_SCOPE("VectorEnv::Step");
+
+    for (int env = 0; env < numEnvs; env++) {
+        Game &game = games[env];
+
+        if (actions[env] < numEnvActions) {
+            game.Execute((Command)actions[env]);
+        }
+
+        for (int tick = 0; tick < ticksPerStep; tick++) {
+            game.Tick();
+        }
+
+        int64_t reward = game.score - scores[env];
+        scores[env] = game.score;
+        steps[env]++;
+
+        bool done = game.gameOver || (maxSteps > 0 && steps[env] >= maxSteps);
+        if (done) {
+            Restart(env);
+        }
+
+        Observe(env, buffers);
+
+        if (buffers.rewards != nullptr) {
+            buffers.rewards[env] = (float)reward;
+        }
+        if (buffers.dones != nullptr) {
+            buffers.dones[env] = done ? 1 : 0;
+        }
+    }
+}
+
+/// @brief Writes the playboard, current, held and upcoming tetrominoes of an environment.
+void VectorEnv::Observe(int env, const EnvBuffers &buffers) const {
+    const Game &game = games[env];
+
+    if (buffers.cells != nullptr) {
+        uint8_t *cells = buffers.cells + (size_t)env * 200;
+        const uint16_t *rows = game.GetGrid().rows;
+
+        for (int row = 0; row < 20; row++) {
+            memcpy(cells + row * 10, rowCells.cells[(rows[row] >> wallBits) & 0x3FF], 10);
+        }
+    }
+
+    if (buffers.pieces != nullptr) {
+        const Block &current = game.GetCurrentBlock();
+        int8_t *piece = buffers.pieces + (size_t)env * 4;
+        piece[0] = current.id;
+        piece[1] = current.rotationState;
+        piece[2] = current.row;
+        piece[3] = current.col;
+    }
+
+    if (buffers.holds != nullptr) {
+        buffers.holds[env] = game.GetHeldBlock().id;
+    }
+
+    if (buffers.queues != nullptr) {
+        int8_t *queue = buffers.queues + (size_t)env * numPreviews;
+
+        for (int i = 0; i < numPreviews; i++) {
+            queue[i] = (int8_t)game.Preview(i);
+        }
+    }
+}
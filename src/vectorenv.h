@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "game.h"
+
+
+// Actions of a step, the player commands except `Command::Restart`; finished games restart on their own
+const int numEnvActions = 7;
+
+// Caller-owned buffers the environments write to, one entry (or row of entries) per environment, contiguous
+// `cells`: `numEnvs * 200` bytes, row-major playboard of each environment, `1` for a filled cell
+// `pieces`: `numEnvs * 4`, id, rotation state, row and column of the current tetromino
+// `holds`: held tetromino id, `0` for none; `queues`: `numEnvs * numPreviews` upcoming tetromino ids
+// `rewards`: score gained by the step; `dones`: `1` if the game ended on the step and was restarted
+// Any pointer may be `nullptr` to skip that output
+struct EnvBuffers {
+    uint8_t *cells;
+    int8_t *pieces;
+    int8_t *holds;
+    int8_t *queues;
+    float *rewards;
+    uint8_t *dones;
+};
+
+// Independent games stepped together with one action each
+// Games are stored contiguously, and the per-environment bookkeeping as one array per field, so that a step
+// walks memory in order and nothing is allocated after construction
+class VectorEnv {
+    public:
+        VectorEnv(int numEnvs, uint32_t seed, int numPreviews = defaultPreviews, int ticksPerStep = 1,
+                  int maxSteps = 0);
+        int NumEnvs() const;
+        int NumPreviews() const;
+        void Reset(const EnvBuffers &buffers);
+        void Step(const uint8_t actions[], const EnvBuffers &buffers);
+        const Game &GetGame(int env) const;
+
+    private:
+        int numEnvs;
+        int numPreviews;
+        int ticksPerStep;
+        int maxSteps;
+        uint32_t seed;
+        std::vector<Game> games;
+        std::vector<int64_t> scores;
+        std::vector<int> steps;
+        std::vector<uint32_t> episodes;
+        void Restart(int env);
+        void Observe(int env, const EnvBuffers &buffers) const;
+};
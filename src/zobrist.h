@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include "grid.h"
+#include "tetrominoes.h"
+
+
+// Zobrist keys: a game state hashes to the XOR of the keys of its filled cells, current and held tetromino,
+// position in the tetromino queue and whether the hold has been used since the last lock
+// Cell keys are stored per half row, so that the key of a whole row of 5 + 5 columns takes two lookups
+// `rows[row][half][bits]` is the XOR of the keys of the filled columns `half * 5 + n` for every set bit `n`
+struct ZobristKeys {
+    uint64_t rows[20][2][32];
+    uint64_t current[8];
+    uint64_t hold[8];
+    uint64_t justHeld;
+    uint64_t queue;
+};
+
+/// @brief SplitMix64 finaliser, used to derive the keys from their index.
+constexpr uint64_t ZobristMix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+constexpr ZobristKeys BuildZobristKeys() {
+    ZobristKeys keys = {};
+    uint64_t index = 0;
+
+    for (int row = 0; row < 20; row++) {
+        for (int half = 0; half < 2; half++) {
+            uint64_t cellKeys[5] = {};
+            for (int bit = 0; bit < 5; bit++) {
+                cellKeys[bit] = ZobristMix(index++);
+            }
+
+            for (int bits = 0; bits < 32; bits++) {
+                for (int bit = 0; bit < 5; bit++) {
+                    if ((bits >> bit) & 1) {
+                        keys.rows[row][half][bits] ^= cellKeys[bit];
+                    }
+                }
+            }
+        }
+    }
+
+    // Id `0`, i.e. no tetromino, hashes to `0`
+    for (int id = 1; id <= numTetrominoes; id++) {
+        keys.current[id] = ZobristMix(index++);
+        keys.hold[id] = ZobristMix(index++);
+    }
+
+    keys.justHeld = ZobristMix(index++);
+    keys.queue = ZobristMix(index++);
+
+    return keys;
+}
+
+constexpr ZobristKeys zobristKeys = BuildZobristKeys();
+
+/// @brief Key of the filled cells of a row.
+/// @param row Row of the playboard.
+/// @param bits Occupancy of the row including the walls, see `Grid::rows`.
+inline uint64_t ZobristRow(int row, uint16_t bits) {
+    return zobristKeys.rows[row][0][(bits >> wallBits) & 31] ^ zobristKeys.rows[row][1][(bits >> (wallBits + 5)) & 31];
+}
+
+/// @brief Key of a single filled cell.
+inline uint64_t ZobristCell(int row, int col) {
+    return zobristKeys.rows[row][col / 5][1 << (col % 5)];
+}
+
+/// @brief Key of the position in the tetromino queue, i.e. the number of tetrominoes dealt.
+inline uint64_t ZobristQueue(uint64_t dealt) {
+    return ZobristMix(dealt ^ zobristKeys.queue);
+}
@@ -0,0 +1,51 @@
+#include <cstdio>
+
+
+/**
+ * @brief Writes the bytes of a file as a C++ source defining `NAMEData` and `NAMESize`, see `src/assets.h`.
+ * @details A missing input defines an empty asset, so the game builds without optional files and falls back
+ * to loading them from disk.
+ * @return Exit code of the program.
+ */
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        printf("Usage: %s NAME INPUT OUTPUT\n", argv[0]);
+        printf("  Embeds INPUT into the C++ source OUTPUT as NAMEData and NAMESize.\n");
+        return 1;
+    }
+
+    const char *name = argv[1];
+    FILE *input = fopen(argv[2], "rb");
+    FILE *output = fopen(argv[3], "w");
+
+    if (output == nullptr) {
+        fprintf(stderr, "Cannot write: %s\n", argv[3]);
+        return 1;
+    }
+
+    fprintf(output, "// Generated by tools/embed.cpp from %s, do not edit\n\n", argv[2]);
+    fprintf(output, "extern const unsigned char %sData[];\nextern const unsigned int %sSize;\n\n", name, name);
+    fprintf(output, "alignas(16) const unsigned char %sData[] = {", name);
+
+    unsigned int size = 0;
+    int byte;
+
+    while (input != nullptr && (byte = fgetc(input)) != EOF) {
+        fprintf(output, "%s%u,", (size % 24 == 0) ? "\n    " : "", (unsigned int)byte);
+        size++;
+    }
+
+    // Arrays cannot be empty
+    if (size == 0) {
+        fprintf(output, "\n    0");
+    }
+
+    fprintf(output, "\n};\n\nconst unsigned int %sSize = %u;\n", name, size);
+
+    if (input != nullptr) {
+        fclose(input);
+    }
+    fclose(output);
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+#include "game.h"
+#include "movegen.h"
+#include "threadpool.h"
+#include "transposition.h"
+
+
+// Letters of the tetromino ids, see `tetrominoes.h`
+const char pieceNames[8] = {'-', 'O', 'I', 'S', 'Z', 'L', 'J', 'T'};
+
+// Playboards the search can start from
+struct Setup {
+    const char *name;
+    GameState state;
+};
+
+const Setup setups[] = {
+    {"empty", GameState::Empty},
+    {"triple", GameState::TripleTSpin},
+    {"double", GameState::DoubleTSpinRegular},
+    {"double-mini", GameState::DoubleTSpinMini},
+    {"single", GameState::SingleTSpinRegular},
+    {"single-mini", GameState::SingleTSpinMini},
+};
+
+// Options and scratch space of one worker's search
+// `leaves` collects the hashes of the states reached at the last depth, see `Game::Hash()`
+struct Search {
+    bool allowHold;
+    std::vector<MoveGenerator> moves;
+    std::unordered_set<uint64_t> *leaves;
+    TranspositionTable *table;
+};
+
+// A first move and the state it leads to; the searches below them are spread across the workers
+struct RootMove {
+    Game game;
+    Placement placement;
+    bool held;
+};
+
+/// @brief Prints usage information.
+void PrintUsage(const char *program) {
+    printf("Usage: %s [--depth N] [--setup NAME] [--seed N] [--no-hold] [--threads N] [--hash MB] [--distinct] [--divide] [--expect N]\n", program);
+    printf("  --depth N    Placements to search, each depth from 1 to N is reported (default 3)\n");
+    printf("  --setup NAME Playboard to start from (default triple):");
+
+    for (const Setup &setup: setups) {
+        printf(" %s", setup.name);
+    }
+
+    printf("\n");
+    printf("  --seed N     Seed of the tetromino queue (default 1)\n");
+    printf("  --no-hold    Only place the current tetromino\n");
+    printf("  --threads N  Worker threads, 0 for every hardware thread (default 1)\n");
+    printf("  --hash MB    Size of the transposition table, 0 to search every node (default 64)\n");
+    printf("  --distinct   Also count distinct states at each depth (single thread, no transposition table)\n");
+    printf("  --divide     Print the count below every first placement at the last depth\n");
+    printf("  --expect N   Exit with an error unless the last depth has N nodes\n");
+}
+
+/**
+ * @brief Counts the leaf nodes of the game tree below a game state.
+ * @details A move places the current tetromino at one of the placements found by `MoveGenerator`, or holds
+ * it first and places the tetromino that takes its place. Holding is skipped when the held tetromino is
+ * the current one, as it leads to the same states. Placements are locked with `Game::Place()`, so line
+ * clears and top outs follow the real rules. A game that has topped out has no moves.
+ * States reached again through another order of moves are looked up in the transposition table.
+ * @param game State to search from.
+ * @param depth Placements left to make.
+ * @param search Options and scratch space of the search.
+ * @return Number of move sequences of length `depth`.
+ */
+uint64_t Perft(const Game &game, int depth, Search &search) {
+    if (depth == 0) {
+        if (search.leaves != nullptr) {
+            search.leaves -> insert(game.Hash());
+        }
+
+        return 1;
+    }
+
+    if (game.gameOver) {
+        return 0;
+    }
+
+    // Transpositions are only skipped when the leaves themselves are not needed
+    TranspositionTable *table = (search.leaves == nullptr) ? search.table : nullptr;
+    TranspositionEntry entry;
+    uint64_t key = game.Hash();
+
+    if (table != nullptr && table -> Probe(key, entry) && entry.depth == depth) {
+        return (uint64_t)entry.value;
+    }
+
+    uint64_t nodes = 0;
+    int numOptions = (search.allowHold && game.GetHeldBlock().id != game.GetCurrentBlock().id) ? 2 : 1;
+    MoveGenerator &moves = search.moves[depth];
+
+    for (int option = 0; option < numOptions; option++) {
+        Game base = game;
+
+        if (option == 1) {
+            base.Execute(Command::Hold);
+
+            if (base.gameOver) {
+                continue;
+            }
+        }
+
+        int numPlacements = moves.Generate(base.GetGrid(), base.GetCurrentBlock());
+
+        // Bulk count the last ply unless the resulting states are needed
+        if (depth == 1 && search.leaves == nullptr) {
+            nodes += numPlacements;
+            continue;
+        }
+
+        for (int i = 0; i < numPlacements; i++) {
+            Game child = base;
+            child.Place(moves.placements[i]);
+            nodes += Perft(child, depth - 1, search);
+        }
+    }
+
+    if (table != nullptr) {
+        table -> Store(key, {(int64_t)nodes, depth, 0});
+    }
+
+    return nodes;
+}
+
+/// @brief Lists every first move: each placement of the current tetromino, then of the one the hold swaps in.
+std::vector<RootMove> ListRootMoves(const Game &game, bool allowHold) {
+    int numOptions = (allowHold && game.GetHeldBlock().id != game.GetCurrentBlock().id) ? 2 : 1;
+    std::vector<RootMove> rootMoves;
+    MoveGenerator moves;
+
+    for (int option = 0; option < numOptions; option++) {
+        Game base = game;
+
+        if (option == 1) {
+            base.Execute(Command::Hold);
+
+            if (base.gameOver) {
+                continue;
+            }
+        }
+
+        int numPlacements = moves.Generate(base.GetGrid(), base.GetCurrentBlock());
+        for (int i = 0; i < numPlacements; i++) {
+            RootMove rootMove = {base, moves.placements[i], option == 1};
+            rootMove.game.Place(rootMove.placement);
+            rootMoves.push_back(rootMove);
+        }
+    }
+
+    return rootMoves;
+}
+
+int main(int argc, char **argv) {
+    int maxDepth = 3;
+    const Setup *setup = &setups[1];
+    uint32_t seed = 1;
+    bool distinct = false;
+    bool divide = false;
+    long long expected = -1;
+    int numThreads = 1;
+    size_t hashMegabytes = 64;
+    uint64_t nodes = 0;
+    Search search;
+    search.allowHold = true;
+    search.leaves = nullptr;
+    search.table = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--depth") == 0 && hasValue) {
+            maxDepth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--setup") == 0 && hasValue) {
+            setup = nullptr;
+            i++;
+
+            for (const Setup &candidate: setups) {
+                if (strcmp(candidate.name, argv[i]) == 0) {
+                    setup = &candidate;
+                }
+            }
+
+            if (setup == nullptr) {
+                fprintf(stderr, "Unknown setup: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            numThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hash") == 0 && hasValue) {
+            hashMegabytes = (size_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--no-hold") == 0) {
+            search.allowHold = false;
+        } else if (strcmp(argv[i], "--distinct") == 0) {
+            distinct = true;
+        } else if (strcmp(argv[i], "--divide") == 0) {
+            divide = true;
+        } else if (strcmp(argv[i], "--expect") == 0 && hasValue) {
+            expected = atoll(argv[++i]);
+        } else {
+            PrintUsage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    if (maxDepth < 1) {
+        fprintf(stderr, "Depth must be at least 1\n");
+        return 1;
+    }
+
+    // Show every tetromino that can be reached, including the one dealt in place of the first hold
+    Game root = Game(seed, (maxDepth < maxPreviews) ? maxDepth : maxPreviews);
+    root.LoadGameState(setup -> state);
+    search.moves.resize(maxDepth + 1);
+
+    // The distinct count gathers every leaf in one set, so it runs on a single thread
+    WorkStealingPool pool = WorkStealingPool(distinct ? 1 : numThreads);
+    std::vector<Search> workerSearches(pool.NumWorkers(), search);
+    TranspositionTable table((hashMegabytes > 0) ? hashMegabytes : 1);
+
+    for (Search &workerSearch: workerSearches) {
+        workerSearch.table = (hashMegabytes > 0) ? &table : nullptr;
+    }
+
+    printf("setup %s, seed %u, hold %s, queue %c", setup -> name, seed, search.allowHold ? "on" : "off",
+           pieceNames[root.GetCurrentBlock().id]);
+    for (int i = 0; i < root.NumPreviews(); i++) {
+        printf("%c", pieceNames[root.Preview(i)]);
+    }
+    printf("\n%d threads, ", pool.NumWorkers());
+    if (hashMegabytes > 0) {
+        printf("transposition table of %zu entries\n\n", table.NumEntries());
+    } else {
+        printf("no transposition table\n\n");
+    }
+
+    printf("%5s %16s %16s %10s %14s\n", "depth", "nodes", distinct ? "distinct" : "", "seconds", "nodes/s");
+
+    std::vector<RootMove> rootMoves = ListRootMoves(root, search.allowHold);
+    int numRootMoves = (int)rootMoves.size();
+    std::vector<uint64_t> rootCounts(numRootMoves);
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        std::unordered_set<uint64_t> leaves;
+        workerSearches[0].leaves = distinct ? &leaves : nullptr;
+
+        auto start = std::chrono::steady_clock::now();
+        pool.Run(numRootMoves, [&](int task, int worker) {
+            rootCounts[task] = Perft(rootMoves[task].game, depth - 1, workerSearches[worker]);
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        nodes = 0;
+        for (uint64_t count: rootCounts) {
+            nodes += count;
+        }
+
+        char distinctText[24] = "";
+        if (distinct) {
+            snprintf(distinctText, sizeof(distinctText), "%llu", (unsigned long long)leaves.size());
+        }
+
+        printf("%5d %16llu %16s %10.3f %14.0f\n", depth, (unsigned long long)nodes, distinctText, seconds,
+               (seconds > 0) ? nodes / seconds : 0.0);
+    }
+
+    // Count below every first move at the last depth, to compare two move generators one branch at a time
+    if (divide) {
+        printf("\n");
+
+        for (int i = 0; i < numRootMoves; i++) {
+            const Placement &placement = rootMoves[i].placement;
+
+            printf("%s%c r%d (%d, %d)%s: %llu\n", rootMoves[i].held ? "hold " : "", pieceNames[placement.block.id],
+                   placement.block.rotationState, placement.block.row, placement.block.col,
+                   placement.isTSpin ? " t-spin" : "", (unsigned long long)rootCounts[i]);
+        }
+    }
+
+    if (expected >= 0 && nodes != (uint64_t)expected) {
+        printf("\nMISMATCH: expected %lld nodes at depth %d\n", expected, maxDepth);
+        return 1;
+    }
+
+    return 0;
+}
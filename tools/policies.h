@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include "game.h"
+#include "movegen.h"
+#include "stackfeatures.h"
+
+
+// Placement policy for bots: picks one of the placements listed by `MoveGenerator`
+// `rng` is owned by the caller so that policies stay reproducible and thread safe
+struct Policy {
+    const char *name;
+    int (*Choose)(const Game &game, const MoveGenerator &moves, std::mt19937 &rng);
+};
+
+// Shape of the stack after a placement, as used by the evaluation functions
+struct BoardFeatures {
+    int rowsCleared;
+    int landingHeight;
+    StackFeatures stack;
+};
+
+/**
+ * @brief Locks every placement on a copy of the playboard and measures the resulting stacks.
+ * @details The stacks are measured together by the vector kernel of `ComputeStackFeatures()`.
+ * Buffers are kept per thread, so no memory is allocated once they have grown to the largest batch.
+ * @param grid Playboard before the placements.
+ * @param moves Placements to evaluate.
+ * @return Features of the playboard after each placement and any line clears, in the order of `moves.placements`.
+ */
+inline const BoardFeatures *EvaluatePlacements(const Grid &grid, const MoveGenerator &moves) {
+    static thread_local std::vector<Grid> after;
+    static thread_local std::vector<StackFeatures> stacks;
+    static thread_local std::vector<BoardFeatures> features;
+    int numPlacements = moves.numPlacements;
+
+    if ((int)after.size() < numPlacements) {
+        after.resize(numPlacements);
+        stacks.resize(numPlacements);
+        features.resize(numPlacements);
+    }
+
+    for (int i = 0; i < numPlacements; i++) {
+        const Block &block = moves.placements[i].block;
+        int lowestRow = 0;
+        after[i] = grid;
+
+        for (Position item: block.GetCellPositions()) {
+            after[i].SetCell(item.row, item.col, block.id);
+            lowestRow = (item.row > lowestRow) ? item.row : lowestRow;
+        }
+
+        features[i].landingHeight = 20 - lowestRow;
+        features[i].rowsCleared = after[i].ClearFullRows();
+    }
+
+    ComputeStackFeatures(after.data(), numPlacements, stacks.data());
+
+    for (int i = 0; i < numPlacements; i++) {
+        features[i].stack = stacks[i];
+    }
+
+    return features.data();
+}
+
+/// @brief Picks any placement with equal probability.
+inline int ChooseRandom(const Game &game, const MoveGenerator &moves, std::mt19937 &rng) {
+    return (int)(rng() % moves.numPlacements);
+}
+
+/// @brief Picks the placement that lands lowest, preferring the one that leaves the fewest holes.
+inline int ChooseLowest(const Game &game, const MoveGenerator &moves, std::mt19937 &rng) {
+    const BoardFeatures *features = EvaluatePlacements(game.GetGrid(), moves);
+    int best = 0;
+    int bestScore = 0;
+
+    for (int i = 0; i < moves.numPlacements; i++) {
+        int score = -features[i].landingHeight * 100 - features[i].stack.holes;
+
+        if (i == 0 || score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+
+    return best;
+}
+
+/// @brief Picks the placement with the best weighted sum of lines, height, holes and bumpiness.
+/// @details Weights are from Yiyuan Lee's genetic algorithm tuned evaluation. T-Spins get a bonus so that
+/// the policy takes them when the stack allows.
+inline int ChooseHeuristic(const Game &game, const MoveGenerator &moves, std::mt19937 &rng) {
+    const BoardFeatures *features = EvaluatePlacements(game.GetGrid(), moves);
+    int best = 0;
+    double bestScore = 0;
+
+    for (int i = 0; i < moves.numPlacements; i++) {
+        const Placement &placement = moves.placements[i];
+        double score = -0.510066 * features[i].stack.aggregateHeight
+                     + 0.760666 * features[i].rowsCleared
+                     - 0.35663 * features[i].stack.holes
+                     - 0.184483 * features[i].stack.bumpiness;
+
+        if (placement.isTSpin && features[i].rowsCleared > 0) {
+            score += placement.tSpinType ? 1.0 : 0.25;
+        }
+
+        if (i == 0 || score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+
+    return best;
+}
+
+const Policy policies[] = {
+    {"random", ChooseRandom},
+    {"lowest", ChooseLowest},
+    {"heuristic", ChooseHeuristic},
+};
+
+const int numPolicies = sizeof(policies) / sizeof(policies[0]);
+
+/// @brief Finds a policy by name.
+/// @return The policy, or `nullptr` if no policy has that name.
+inline const Policy *FindPolicy(const char *name) {
+    for (const Policy &policy: policies) {
+        if (strcmp(policy.name, name) == 0) {
+            return &policy;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <cstring>
+#include "game.h"
+#include "replay.h"
+
+
+// Names of the event codes, indexed by code
+const char *eventNames[16] = {
+    "MoveLeft", "MoveRight", "SoftDrop", "HardDrop", "RotateClockwise", "RotateCounterClockwise", "Hold", "Restart",
+    "SoftDropPressed", "SoftDropReleased", "Place", "LeftPressed", "LeftReleased", "RightPressed", "RightReleased", "End",
+};
+
+/// @brief Prints every record of a replay file.
+/// @return Exit code of the program.
+int Dump(const char *path) {
+    ReplayReader reader;
+    ReplayEntry entry;
+
+    if (!reader.Open(path)) {
+        fprintf(stderr, "Cannot read replay: %s\n", path);
+        return 1;
+    }
+
+    printf("seed %u, start %d, DAS %d, ARR %d, soft drop %d\n", reader.seed, (int)reader.start,
+           reader.handling.dasTicks, reader.handling.arrTicks, reader.handling.softDropTicks);
+    while (reader.Next(entry)) {
+        printf("%10llu %s", (unsigned long long)entry.tick, eventNames[entry.code]);
+
+        if (entry.code == (uint8_t)ReplayEvent::Place) {
+            printf(" rotation %d row %d col %d%s", entry.placement.block.rotationState, entry.placement.block.row,
+                   entry.placement.block.col, entry.placement.isTSpin ? " t-spin" : "");
+        } else if (entry.code == (uint8_t)ReplayEvent::End) {
+            printf(" score %lld lines %d", (long long)entry.score, entry.linesCleared);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}
+
+/// @brief Replays a file on a new game and checks the result against the recording.
+/// @return Exit code of the program: `0` if the replay reproduces the recorded game.
+int Verify(const char *path) {
+    ReplayReader reader;
+    ReplayEntry end = ReplayEntry();
+
+    if (!reader.Open(path)) {
+        fprintf(stderr, "Cannot read replay: %s\n", path);
+        return 1;
+    }
+
+    Game game = Game(reader.seed);
+
+    bool matches = reader.Play(game, end);
+    printf("seed %u, %llu ticks\n", reader.seed, (unsigned long long)game.CurrentTick());
+    printf("replayed: score %lld lines %d\n", (long long)game.score, game.linesCleared);
+
+    if (end.code != (uint8_t)ReplayEvent::End) {
+        printf("recorded: no end record, replay is incomplete\n");
+        return 1;
+    }
+
+    printf("recorded: score %lld lines %d\n", (long long)end.score, end.linesCleared);
+    printf("%s\n", matches ? "OK" : "MISMATCH");
+
+    return matches ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0) {
+        return Dump(argv[2]);
+    }
+
+    if (argc == 2) {
+        return Verify(argv[1]);
+    }
+
+    printf("Usage: %s [--dump] FILE\n", argv[0]);
+    printf("  Replays FILE and checks the final score and lines against the recording,\n");
+    printf("  or prints every recorded event with --dump.\n");
+
+    return 1;
+}
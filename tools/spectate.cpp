@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "broadcast.h"
+
+
+// Tetromino letters, indexed by id
+const char pieceNames[] = ".OISZLJT";
+
+// Delay between polls of the ring; the game publishes 60 frames per second
+const int pollMilliseconds = 16;
+
+/// @brief Prints one line of a snapshot, for overlays that read standard output.
+void PrintLine(const SpectatorSnapshot &snapshot, uint64_t dropped) {
+    printf("tick %llu score %lld lines %d combo %d piece %c hold %c queue ", (unsigned long long)snapshot.tick,
+           (long long)snapshot.score, snapshot.linesCleared, snapshot.comboCount, pieceNames[snapshot.piece[0] & 7],
+           pieceNames[snapshot.hold & 7]);
+
+    for (int i = 0; i < snapshot.numPreviews; i++) {
+        putchar(pieceNames[snapshot.queue[i] & 7]);
+    }
+
+    printf("%s%s%s%s dropped %llu\n", (snapshot.flags & spectatorB2BActive) ? " b2b" : "",
+           (snapshot.flags & spectatorTSpinRegular) ? " t-spin" : "",
+           (snapshot.flags & spectatorTSpinMini) ? " t-spin-mini" : "",
+           (snapshot.flags & spectatorGameOver) ? " game-over" : "", (unsigned long long)dropped);
+}
+
+/// @brief Redraws the playboard and the line summary of a snapshot in the terminal.
+void PrintBoard(const SpectatorSnapshot &snapshot, uint64_t dropped) {
+    char board[20][11];
+
+    for (int row = 0; row < 20; row++) {
+        for (int col = 0; col < 10; col++) {
+            board[row][col] = ((snapshot.rows[row] >> col) & 1) ? '#' : '.';
+        }
+        board[row][10] = '\0';
+    }
+
+    // Cells of the current tetromino, from its id, rotation state and position
+    if (snapshot.piece[0] > 0 && !(snapshot.flags & spectatorGameOver)) {
+        Block block = Block(snapshot.piece[0]);
+        block.rotationState = snapshot.piece[1];
+        block.row = snapshot.piece[2];
+        block.col = snapshot.piece[3];
+
+        for (const Position &cell: block.GetCellPositions()) {
+            if (cell.row >= 0 && cell.row < 20 && cell.col >= 0 && cell.col < 10) {
+                board[cell.row][cell.col] = pieceNames[snapshot.piece[0]];
+            }
+        }
+    }
+
+    printf("\x1b[H\x1b[2J");
+    for (int row = 0; row < 20; row++) {
+        printf("|%s|\n", board[row]);
+    }
+    PrintLine(snapshot, dropped);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    const char *name = spectatorName;
+    long count = 0;
+    bool lines = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--lines") == 0) {
+            lines = true;
+        } else {
+            printf("Usage: %s [--name NAME] [--count N] [--lines]\n", argv[0]);
+            printf("Follows the game running on this machine. --lines prints every snapshot as one line instead of\n");
+            printf("redrawing the playboard; --count stops after N snapshots.\n");
+            return 1;
+        }
+    }
+
+    SpectatorReader reader;
+    while (!reader.Open(name)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+
+    SpectatorSnapshot snapshot;
+    long seen = 0;
+
+    while (count == 0 || seen < count) {
+        bool updated = false;
+
+        while ((count == 0 || seen < count) && reader.Next(snapshot)) {
+            updated = true;
+            seen++;
+
+            if (lines) {
+                PrintLine(snapshot, reader.Dropped());
+            }
+        }
+
+        if (updated && !lines) {
+            PrintBoard(snapshot, reader.Dropped());
+        }
+
+        if (lines) {
+            fflush(stdout);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollMilliseconds));
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Work-stealing pool for batches of independent tasks, numbered `0` to `numTasks - 1`
+// Each worker owns a deque; it takes its own tasks from the back and steals from the front of the others
+class WorkStealingPool {
+    public:
+        WorkStealingPool(int numWorkers);
+        int NumWorkers() const;
+        void Run(int numTasks, const std::function<void(int task, int worker)> &work);
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<int> tasks;
+        };
+
+        int numWorkers;
+        std::vector<WorkQueue> queues;
+        bool PopOwn(int worker, int &task);
+        bool Steal(int worker, int &task);
+};
+
+/// @brief Initialises the pool.
+/// @param numWorkers Number of threads; `0` uses every hardware thread.
+inline WorkStealingPool::WorkStealingPool(int numWorkers) {
+    if (numWorkers <= 0) {
+        numWorkers = (int)std::thread::hardware_concurrency();
+    }
+
+    this -> numWorkers = (numWorkers > 0) ? numWorkers : 1;
+    queues = std::vector<WorkQueue>(this -> numWorkers);
+}
+
+/// @brief Number of threads tasks are spread across.
+inline int WorkStealingPool::NumWorkers() const {
+    return numWorkers;
+}
+
+/**
+ * @brief Runs every task and returns once all of them have finished.
+ * @details Tasks are dealt to the workers in contiguous blocks. A worker that runs out of tasks steals
+ * from the front of another worker's deque, i.e. the tasks that worker would have reached last.
+ * @param numTasks Number of tasks.
+ * @param work Function called once per task with the task number and the index of the worker running it,
+ * so that results can be gathered per worker without locking.
+ */
+inline void WorkStealingPool::Run(int numTasks, const std::function<void(int task, int worker)> &work) {
+    for (int worker = 0; worker < numWorkers; worker++) {
+        int first = (int)((long long)numTasks * worker / numWorkers);
+        int last = (int)((long long)numTasks * (worker + 1) / numWorkers);
+
+        for (int task = first; task < last; task++) {
+            queues[worker].tasks.push_back(task);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < numWorkers; worker++) {
+        threads.emplace_back([this, worker, &work]() {
+            int task;
+
+            while (PopOwn(worker, task) || Steal(worker, task)) {
+                work(task, worker);
+            }
+        });
+    }
+
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+}
+
+/// @brief Takes the most recently dealt task of a worker's own deque.
+/// @return `true` if a task was taken, `false` if the deque is empty.
+inline bool WorkStealingPool::PopOwn(int worker, int &task) {
+    std::lock_guard<std::mutex> lock(queues[worker].mutex);
+
+    if (queues[worker].tasks.empty()) {
+        return false;
+    }
+
+    task = queues[worker].tasks.back();
+    queues[worker].tasks.pop_back();
+    return true;
+}
+
+/// @brief Takes the oldest task of another worker's deque, trying the next workers in turn.
+/// @details No tasks are added while running, so once every deque is empty the worker can stop.
+/// @return `true` if a task was stolen, `false` if every deque is empty.
+inline bool WorkStealingPool::Steal(int worker, int &task) {
+    for (int i = 1; i < numWorkers; i++) {
+        WorkQueue &victim = queues[(worker + i) % numWorkers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
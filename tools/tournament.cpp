@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "game.h"
+#include "movegen.h"
+#include "policies.h"
+#include "replay.h"
+#include "threadpool.h"
+
+
+// Results of every game played by one policy
+// Aligned so that workers updating neighbouring entries do not share a cache line
+struct alignas(64) PolicyStats {
+    long long games;
+    long long pieces;
+    long long score;
+    long long lines;
+    long long tSpins;
+    long long maxCombo;
+    long long topOuts;
+};
+
+/// @brief Prints usage information.
+void PrintUsage(const char *program) {
+    printf("Usage: %s [--games N] [--pieces N] [--threads N] [--seed N] [--record DIR] [--policy NAME]...\n", program);
+    printf("  --games N    Games per policy (default 1000)\n");
+    printf("  --pieces N   Pieces before a game that has not topped out is stopped (default 1000)\n");
+    printf("  --threads N  Worker threads, 0 for every hardware thread (default 0)\n");
+    printf("  --seed N     Seed of the first game; game i uses seed + i for every policy (default 1)\n");
+    printf("  --record DIR Write a replay of every game to DIR/<policy>-<game>.trp\n");
+    printf("  --policy     Policy to play, may be repeated (default all):");
+
+    for (const Policy &policy: policies) {
+        printf(" %s", policy.name);
+    }
+
+    printf("\n");
+}
+
+/**
+ * @brief Plays a single game with a policy, using the real rules of `Game` for every lock and score.
+ * @param policy Policy that chooses every placement.
+ * @param seed Seed of the game and of the policy's own random choices.
+ * @param maxPieces Pieces before the game is stopped.
+ * @param moves Move generator owned by the calling worker.
+ * @param stats Results to add the game to.
+ * @param replayPath Path to record the game to, `nullptr` to not record it.
+ */
+void PlayGame(const Policy &policy, uint32_t seed, int maxPieces, MoveGenerator &moves, PolicyStats &stats,
+              const char *replayPath) {
+    Game game = Game(seed);
+    ReplayWriter recorder;
+    std::mt19937 rng(seed);
+    int pieces = 0;
+    int maxCombo = 0;
+
+    // Start from an empty playboard rather than the demo setup, as `VectorEnv` and perft do
+    game.LoadGameState(GameState::Empty);
+
+    if (replayPath != nullptr) {
+        if (recorder.Open(replayPath, game, GameState::Empty)) {
+            game.recorder = &recorder;
+        } else {
+            fprintf(stderr, "Cannot write replay: %s\n", replayPath);
+        }
+    }
+
+    while (!game.gameOver && pieces < maxPieces) {
+        if (moves.Generate(game.GetGrid(), game.GetCurrentBlock()) == 0) {
+            game.gameOver = true;
+            break;
+        }
+
+        game.Place(moves.placements[policy.Choose(game, moves, rng)]);
+        pieces++;
+
+        if (game.tSpinRegular || game.tSpinMini) {
+            stats.tSpins++;
+        }
+
+        maxCombo = (game.comboCount > maxCombo) ? game.comboCount : maxCombo;
+    }
+
+    recorder.Close(game.CurrentTick(), game.score, game.linesCleared);
+
+    stats.games++;
+    stats.pieces += pieces;
+    stats.score += game.score;
+    stats.lines += game.linesCleared;
+    stats.maxCombo += maxCombo;
+    stats.topOuts += game.gameOver ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    int numGames = 1000;
+    int maxPieces = 1000;
+    int numThreads = 0;
+    uint32_t seed = 1;
+    const char *recordDir = nullptr;
+    std::vector<const Policy *> selected;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--games") == 0 && hasValue) {
+            numGames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pieces") == 0 && hasValue) {
+            maxPieces = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            numThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordDir = argv[++i];
+        } else if (strcmp(argv[i], "--policy") == 0 && hasValue) {
+            const Policy *policy = FindPolicy(argv[++i]);
+
+            if (policy == nullptr) {
+                fprintf(stderr, "Unknown policy: %s\n", argv[i]);
+                return 1;
+            }
+            selected.push_back(policy);
+        } else {
+            PrintUsage(argv[0]);
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    if (selected.empty()) {
+        for (const Policy &policy: policies) {
+            selected.push_back(&policy);
+        }
+    }
+
+    WorkStealingPool pool = WorkStealingPool(numThreads);
+    int numSelected = (int)selected.size();
+
+    // Results and move generators are kept per worker, then merged once every game is over
+    std::vector<PolicyStats> workerStats(pool.NumWorkers() * numSelected, PolicyStats());
+    std::vector<MoveGenerator> workerMoves(pool.NumWorkers());
+
+    auto start = std::chrono::steady_clock::now();
+    pool.Run(numGames * numSelected, [&](int task, int worker) {
+        int policy = task / numGames;
+        int game = task % numGames;
+        char replayPath[4096];
+
+        if (recordDir != nullptr) {
+            snprintf(replayPath, sizeof(replayPath), "%s/%s-%d.trp", recordDir, selected[policy] -> name, game);
+        }
+
+        PlayGame(*selected[policy], seed + (uint32_t)game, maxPieces, workerMoves[worker],
+                 workerStats[worker * numSelected + policy], (recordDir != nullptr) ? replayPath : nullptr);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%d games per policy, up to %d pieces, %d threads, %.2f s\n\n",
+           numGames, maxPieces, pool.NumWorkers(), seconds);
+    printf("%-10s %12s %10s %10s %10s %10s %10s\n",
+           "policy", "score", "lines", "pieces", "t-spins", "max combo", "top-out");
+
+    long long totalPieces = 0;
+    for (int policy = 0; policy < numSelected; policy++) {
+        PolicyStats total = PolicyStats();
+
+        for (int worker = 0; worker < pool.NumWorkers(); worker++) {
+            const PolicyStats &stats = workerStats[worker * numSelected + policy];
+            total.games += stats.games;
+            total.pieces += stats.pieces;
+            total.score += stats.score;
+            total.lines += stats.lines;
+            total.tSpins += stats.tSpins;
+            total.maxCombo += stats.maxCombo;
+            total.topOuts += stats.topOuts;
+        }
+
+        double games = (total.games > 0) ? (double)total.games : 1.0;
+        totalPieces += total.pieces;
+
+        printf("%-10s %12.1f %10.1f %10.1f %10.2f %10.2f %9.1f%%\n",
+               selected[policy] -> name,
+               total.score / games,
+               total.lines / games,
+               total.pieces / games,
+               total.tSpins / games,
+               total.maxCombo / games,
+               100.0 * total.topOuts / games);
+    }
+
+    printf("\nPer game averages; %.0f pieces/s\n", totalPieces / seconds);
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cstring>
+#include "trace.h"
+
+
+// Names of the record types, indexed by `TraceEvent`
+const char *traceEventNames[7] = {"?", "Lock", "Kick", "TSpin", "LineClear", "Combo", "Dropped"};
+
+// Names of `SpinType` values
+const char *spinNames[3] = {"none", "mini", "regular"};
+
+// Tetromino letters, indexed by id
+const char pieceNames[] = ".OISZLJT";
+
+// Totals of a trace for `--summary`
+struct TraceSummary {
+    long long events[7];
+    long long kicks[8];
+    long long corners[5];
+    long long clears[5];
+    long long dropped;
+    int maxCombo;
+};
+
+/// @brief Opens a trace file and checks its header.
+/// @return The file positioned at the first record, or `nullptr` if it is not a trace of this version.
+FILE *OpenTrace(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "Cannot read trace: %s\n", path);
+        return nullptr;
+    }
+
+    uint8_t header[6];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, traceMagic, 4) != 0 ||
+        header[4] != traceVersion || header[5] != sizeof(TraceRecord)) {
+        fprintf(stderr, "Not a version %d trace: %s\n", traceVersion, path);
+        fclose(file);
+        return nullptr;
+    }
+
+    return file;
+}
+
+/// @brief Prints one record as a line of text.
+void PrintRecord(const TraceRecord &record) {
+    int type = (int)record.type;
+    printf("%10llu %-9s", (unsigned long long)record.tick, traceEventNames[(type >= 1 && type <= 6) ? type : 0]);
+
+    switch (record.type) {
+        case TraceEvent::Lock:
+            printf(" %c rotation %d row %d col %d", pieceNames[record.a & 7], record.b, record.c, record.value);
+            break;
+
+        case TraceEvent::Kick:
+            printf(" %c rotation %d -> %d test %d", pieceNames[record.a & 7], record.b, record.c, record.value);
+            break;
+
+        case TraceEvent::TSpin:
+            printf(" center (%d, %d) corners %d %s", record.a, record.b, record.value, record.c ? "regular" : "mini");
+            break;
+
+        case TraceEvent::LineClear:
+            printf(" rows %d spin %s%s lines %d", record.a, spinNames[(record.b >= 0 && record.b <= 2) ? record.b : 0],
+                   record.c ? " b2b" : "", record.value);
+            break;
+
+        case TraceEvent::Combo:
+        case TraceEvent::Dropped:
+            printf(" %d", record.value);
+            break;
+    }
+
+    printf("\n");
+}
+
+/// @brief Adds a record to the totals.
+void Count(TraceSummary &summary, const TraceRecord &record) {
+    int type = (int)record.type;
+    summary.events[(type >= 1 && type <= 6) ? type : 0]++;
+
+    switch (record.type) {
+        case TraceEvent::Kick:
+            summary.kicks[record.value & 7]++;
+            break;
+
+        case TraceEvent::TSpin:
+            summary.corners[(record.value >= 0 && record.value <= 4) ? record.value : 0]++;
+            break;
+
+        case TraceEvent::LineClear:
+            summary.clears[(record.a >= 0 && record.a <= 4) ? record.a : 0]++;
+            break;
+
+        case TraceEvent::Combo:
+            summary.maxCombo = (record.value > summary.maxCombo) ? record.value : summary.maxCombo;
+            break;
+
+        case TraceEvent::Dropped:
+            summary.dropped += record.value;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/// @brief Prints the totals of a trace.
+void PrintSummary(const TraceSummary &summary) {
+    for (int type = 1; type <= 6; type++) {
+        printf("%-9s %lld\n", traceEventNames[type], summary.events[type]);
+    }
+
+    printf("kick tests used:");
+    for (int test = 0; test < 5; test++) {
+        printf(" %d: %lld", test, summary.kicks[test]);
+    }
+
+    printf("\nT-Spin corners filled:");
+    for (int corners = 0; corners <= 4; corners++) {
+        printf(" %d: %lld", corners, summary.corners[corners]);
+    }
+
+    printf("\nline clears:");
+    for (int rows = 1; rows <= 4; rows++) {
+        printf(" %d: %lld", rows, summary.clears[rows]);
+    }
+
+    printf("\nmax combo %d, records dropped %lld\n", summary.maxCombo, summary.dropped);
+}
+
+int main(int argc, char **argv) {
+    bool summarise = argc == 3 && strcmp(argv[1], "--summary") == 0;
+
+    if (argc != 2 && !summarise) {
+        printf("Usage: %s [--summary] FILE\n", argv[0]);
+        printf("  Prints every record of a trace written by the game, or with --summary, totals per record type,\n");
+        printf("  wall kick test and T-Spin corner count.\n");
+        return 1;
+    }
+
+    FILE *file = OpenTrace(argv[argc - 1]);
+    if (file == nullptr) {
+        return 1;
+    }
+
+    TraceSummary summary = TraceSummary();
+    TraceRecord records[256];
+    size_t count;
+
+    while ((count = fread(records, sizeof(TraceRecord), 256, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (summarise) {
+                Count(summary, records[i]);
+            } else {
+                PrintRecord(records[i]);
+            }
+        }
+    }
+
+    if (summarise) {
+        PrintSummary(summary);
+    }
+
+    fclose(file);
+    return 0;
+}